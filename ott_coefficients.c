@@ -0,0 +1,169 @@
+/**
+ * OTT Crossover Coefficient Cache
+ * Process-wide crossover coefficients per (frequency, sample rate)
+ */
+
+#include "ott_plugin.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// ============================================================================
+// STANDARD RATE TABLES
+// ============================================================================
+
+/*
+ * Prewarped gains of the band controls' default crossover points (every
+ * band count, OTT_MIN_BANDS..OTT_MAX_BANDS) at the standard sample rates,
+ * as CrossoverPrewarp computes them. Setting up a default instance at one
+ * of these rates needs no tanf at all.
+ */
+#define STANDARD_RATE_COUNT     6
+#define STANDARD_POINT_COUNT    14
+
+static const float StandardSampleRates[STANDARD_RATE_COUNT] = {
+    44100.0f, 48000.0f, 88200.0f, 96000.0f, 176400.0f, 192000.0f,
+};
+
+// 200 Hz to 2 kHz, ascending
+static const float StandardCrossoverPoints[STANDARD_POINT_COUNT] = {
+    0x1.9p+7f, 0x1.258f54p+8f, 0x1.3cfa88p+8f, 0x1.63a7e8p+8f, 0x1.aee30ep+8f,
+    0x1.f66094p+8f, 0x1.3c3a4ep+9f, 0x1.3c3a5p+9f, 0x1.8e1b72p+9f, 0x1.d028aep+9f,
+    0x1.192bbp+10f, 0x1.3b7a8ap+10f, 0x1.54a562p+10f, 0x1.f4p+10f,
+};
+
+static const float StandardCrossoverPrewarp[STANDARD_RATE_COUNT][STANDARD_POINT_COUNT] = {
+    {   // 44100 Hz
+        0x1.d2e58p-7f, 0x1.56ae94p-6f, 0x1.720744p-6f, 0x1.9f326cp-6f, 0x1.f712aep-6f,
+        0x1.254d9ap-5f, 0x1.7156cap-5f, 0x1.7156ccp-5f, 0x1.d12796p-5f, 0x1.0f451ap-4f,
+        0x1.48e032p-4f, 0x1.7135bcp-4f, 0x1.8ed7b6p-4f, 0x1.25c7f6p-3f,
+    },
+    {   // 48000 Hz
+        0x1.acf4e6p-7f, 0x1.3ad4f6p-6f, 0x1.53f45ep-6f, 0x1.7d7312p-6f, 0x1.ce2cf6p-6f,
+        0x1.0d744cp-5f, 0x1.534b5ep-5f, 0x1.534b6p-5f, 0x1.ab4a0ep-5f, 0x1.f25854p-5f,
+        0x1.2e0db6p-4f, 0x1.531194p-4f, 0x1.6e41aep-4f, 0x1.0d9fd4p-3f,
+    },
+    {   // 88200 Hz
+        0x1.d2df7p-8f, 0x1.56a4fcp-7f, 0x1.71fb3p-7f, 0x1.9f215ep-7f, 0x1.f6f456p-7f,
+        0x1.25358ep-6f, 0x1.7126cap-6f, 0x1.7126ccp-6f, 0x1.d0c7c2p-6f, 0x1.0ef91ep-5f,
+        0x1.4858fp-5f, 0x1.707684p-5f, 0x1.8de6d2p-5f, 0x1.2449p-4f,
+    },
+    {   // 96000 Hz
+        0x1.acf032p-8f, 0x1.3acd86p-7f, 0x1.53eb02p-7f, 0x1.7d65d6p-7f, 0x1.ce157p-7f,
+        0x1.0d61a6p-6f, 0x1.532626p-6f, 0x1.532628p-6f, 0x1.aaffc2p-6f, 0x1.f1e284p-6f,
+        0x1.2da4ep-5f, 0x1.527d62p-5f, 0x1.6d87p-5f, 0x1.0c774ep-4f,
+    },
+    {   // 176400 Hz
+        0x1.d2ddecp-9f, 0x1.56a296p-8f, 0x1.71f82cp-8f, 0x1.9f1d1ap-8f, 0x1.f6eccp-8f,
+        0x1.252f8ap-7f, 0x1.711accp-7f, 0x1.711acep-7f, 0x1.d0afd6p-7f, 0x1.0ee628p-6f,
+        0x1.483734p-6f, 0x1.7046dcp-6f, 0x1.8daadp-6f, 0x1.23e9fep-5f,
+    },
+    {   // 192000 Hz
+        0x1.acef04p-9f, 0x1.3acbaap-8f, 0x1.53e8aap-8f, 0x1.7d6288p-8f, 0x1.ce0f8ep-8f,
+        0x1.0d5cfep-7f, 0x1.531cdap-7f, 0x1.531cdcp-7f, 0x1.aaed32p-7f, 0x1.f1c51ap-7f,
+        0x1.2d8ab6p-6f, 0x1.52586ep-6f, 0x1.6d587ap-6f, 0x1.0c2da6p-5f,
+    },
+};
+
+// The table entry for an exact standard rate and default point, if any
+static bool LookupStandardPrewarp(float frequency, float sampleRate, float* g)
+{
+    for (int rate = 0; rate < STANDARD_RATE_COUNT; rate++) {
+        if (StandardSampleRates[rate] != sampleRate) continue;
+        
+        for (int point = 0; point < STANDARD_POINT_COUNT; point++) {
+            if (StandardCrossoverPoints[point] == frequency) {
+                *g = StandardCrossoverPrewarp[rate][point];
+                return true;
+            }
+        }
+        return false;
+    }
+    return false;
+}
+
+static void ComputeCrossoverCoefficients(CrossoverCoefficients* coefficients, float frequency, float sampleRate)
+{
+    if (!LookupStandardPrewarp(frequency, sampleRate, &coefficients->g)) {
+        coefficients->g = CrossoverPrewarp(frequency, sampleRate);
+    }
+    InitializeBiquadFilter(&coefficients->legacy);
+    CalculateBiquadCoefficientsPrewarped(&coefficients->legacy, coefficients->g);
+    SetSVFCoefficients(&coefficients->lr4, coefficients->g);
+}
+
+// ============================================================================
+// PROCESS-WIDE CACHE
+// ============================================================================
+
+/*
+ * Open-addressed, insert-only table shared by every instance in the
+ * process. A slot is claimed by the first thread to move it from empty to
+ * filling, written, then published as ready with a release store; from
+ * then on it is immutable, so lookups take no lock and sample-rate
+ * changes across many instances compute each point once. When the probe
+ * run holds no free slot, the caller gets its coefficients computed into
+ * its own scratch instead.
+ */
+#define COEFFICIENT_CACHE_SLOTS     1024
+#define COEFFICIENT_CACHE_PROBES    16
+
+enum {
+    COEFFICIENT_SLOT_EMPTY = 0,
+    COEFFICIENT_SLOT_FILLING,
+    COEFFICIENT_SLOT_READY
+};
+
+typedef struct {
+    _Atomic uint32_t state;
+    uint32_t frequencyBits;
+    uint32_t sampleRateBits;
+    CrossoverCoefficients coefficients;
+} CoefficientCacheSlot;
+
+static CoefficientCacheSlot CoefficientCache[COEFFICIENT_CACHE_SLOTS];
+
+static inline uint32_t FloatKeyBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Coefficients for one crossover point, shared from the cache where
+// possible and otherwise computed into scratch; never NULL
+const CrossoverCoefficients* GetCrossoverCoefficients(float frequency, float sampleRate,
+                                                      CrossoverCoefficients* scratch)
+{
+    const uint32_t frequencyBits = FloatKeyBits(frequency);
+    const uint32_t sampleRateBits = FloatKeyBits(sampleRate);
+    uint32_t hash = frequencyBits * 0x9e3779b1u ^ sampleRateBits * 0x85ebca77u;
+    hash ^= hash >> 15;
+    
+    for (uint32_t probe = 0; probe < COEFFICIENT_CACHE_PROBES; probe++) {
+        CoefficientCacheSlot* slot = &CoefficientCache[(hash + probe) & (COEFFICIENT_CACHE_SLOTS - 1)];
+        uint32_t state = atomic_load_explicit(&slot->state, memory_order_acquire);
+        
+        if (state == COEFFICIENT_SLOT_EMPTY) {
+            uint32_t expected = COEFFICIENT_SLOT_EMPTY;
+            if (atomic_compare_exchange_strong_explicit(&slot->state, &expected, COEFFICIENT_SLOT_FILLING,
+                                                        memory_order_acquire, memory_order_acquire)) {
+                slot->frequencyBits = frequencyBits;
+                slot->sampleRateBits = sampleRateBits;
+                ComputeCrossoverCoefficients(&slot->coefficients, frequency, sampleRate);
+                atomic_store_explicit(&slot->state, COEFFICIENT_SLOT_READY, memory_order_release);
+                return &slot->coefficients;
+            }
+            state = expected;
+        }
+        
+        // Still being filled: skip it rather than wait (at worst the same
+        // key ends up in a second slot)
+        if (state == COEFFICIENT_SLOT_FILLING) continue;
+        if (slot->frequencyBits == frequencyBits && slot->sampleRateBits == sampleRateBits) {
+            return &slot->coefficients;
+        }
+    }
+    
+    ComputeCrossoverCoefficients(scratch, frequency, sampleRate);
+    return scratch;
+}
@@ -1,9 +1,17 @@
 #include "ott_plugin.h"
+#include "ott_kernels.h"
 
 // ============================================================================
 // COMPRESSOR INITIALIZATION
 // ============================================================================
 
+// Keeps gainCurve in step with the parameters it is built from. Curves
+// are only looked up (and built on first use) under OTT_MATH_TABLE.
+static void RefreshGainCurve(CompressorState* comp)
+{
+    comp->gainCurve = (comp->mathBackend == OTT_MATH_TABLE) ? GetGainCurve(comp) : NULL;
+}
+
 void InitializeCompressor(CompressorState* comp)
 {
     // Initialize all states to neutral values
@@ -19,16 +27,36 @@ void InitializeCompressor(CompressorState* comp)
     comp->upward_ratio = 2.0;            // 2:1 upward ratio
     comp->envelope_output = 1.0;         // Unity gain
     comp->processed_envelope = 1.0;
+    comp->envelope_level = 1.0;          // exp(log_envelope)
     comp->linear_coeff = 1.0;
     comp->knee_coeff = 0.5;
+    
+    RefreshGainCurve(comp);
+}
+
+// ============================================================================
+// MATH BACKEND DISPATCH
+// ============================================================================
+
+static inline double CompressorExp(double x, bool fastMath)
+{
+    return fastMath ? FastExp(x) : exp(x);
+}
+
+static inline double CompressorLog(double x, bool fastMath)
+{
+    return fastMath ? FastLog(x) : log(x);
 }
 
 // ============================================================================
 // MAIN COMPRESSION PROCESSING FUNCTION
 // ============================================================================
 
-double ProcessCompressorBand(CompressorState* comp, double inputPower, double outputLevel, 
-                            double bandGain, double timeConstant)
+// Shared body; fastMath and gainTable are constants at every call site,
+// so each backend gets its own branch-free copy
+static inline double ProcessCompressorBandImpl(CompressorState* comp, double inputPower, double outputLevel,
+                                               double bandGain, double timeConstant, const bool fastMath,
+                                               const bool gainTable)
 {
     // ========================================================================
     // RMS DETECTION & SMOOTHING
@@ -44,7 +72,15 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
     // ========================================================================
     
     // Calculate exponential of log envelope for processing
-    double envelope_exp = exp(comp->log_envelope * timeConstant);
+    double envelope_exp;
+    if (fastMath && timeConstant == ENVELOPE_TIME_CONSTANT) {
+        // ENVELOPE_TIME_CONSTANT undoes the LOG_SCALE_FACTOR applied when
+        // log_envelope was stored, so this is the level saved last sample.
+        // Reusing it keeps exp() off the sample-to-sample dependency chain.
+        envelope_exp = comp->envelope_level;
+    } else {
+        envelope_exp = CompressorExp(comp->log_envelope * timeConstant, fastMath);
+    }
     double envelope_sqrt = sqrt(comp->rms_smoother);
     
     // Apply absolute value operation (handle negative values)
@@ -66,7 +102,7 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
         double threshold_value = comp->threshold;
         
         // Convert to logarithmic domain for compression processing
-        double log_input = log(envelope_sqrt + 1e-30) * LOG_SCALE_FACTOR;
+        double log_input = CompressorLog(envelope_sqrt + 1e-30, fastMath) * LOG_SCALE_FACTOR;
         double over_threshold = log_input - threshold_value;
         double max_reduction = fmax(0.0, over_threshold);
         
@@ -88,14 +124,21 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
         comp->gain_reduction = compressed_level;
         
         // Calculate final gain reduction based on threshold comparison
-        if (compressed_level <= threshold_value) {
+        if (gainTable) {
+            // Both branches below, read from the curve
+            float envelope;
+            final_gain_reduction = LookupGainCurve(comp->gainCurve, (float)(compressed_level - threshold_value),
+                                                   &envelope);
+            if (compressed_level > threshold_value) comp->processed_envelope = envelope;
+            
+        } else if (compressed_level <= threshold_value) {
             // ================================================================
             // BELOW THRESHOLD - UPWARD COMPRESSION/EXPANSION
             // ================================================================
             
             double release_factor = comp->release_time - UNITY_GAIN;
             double upward_gain = release_factor * compressed_level * timeConstant;
-            final_gain_reduction = exp(upward_gain);
+            final_gain_reduction = CompressorExp(upward_gain, fastMath);
             
             // Apply minimum gain limiting
             if (final_gain_reduction <= MIN_GAIN_THRESHOLD) {
@@ -109,11 +152,11 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
             
             double attack_factor = compressed_level - threshold_value;
             double downward_gain = attack_factor * timeConstant;
-            double gain_multiplier = exp(downward_gain);
+            double gain_multiplier = CompressorExp(downward_gain, fastMath);
             
             // Apply upward ratio processing for musical compression
             double upward_factor = gain_multiplier * comp->upward_ratio;
-            comp->processed_envelope = exp(downward_gain);
+            comp->processed_envelope = gain_multiplier;
             
             // Limit maximum compression ratio to prevent over-compression
             if (upward_factor <= MAX_COMPRESSION_RATIO) {
@@ -122,7 +165,7 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
                 final_gain_reduction = MAX_COMPRESSION_RATIO * timeConstant;
             }
             
-            final_gain_reduction = exp(final_gain_reduction);
+            final_gain_reduction = CompressorExp(final_gain_reduction, fastMath);
         }
         
     } else {
@@ -148,26 +191,34 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
         double final_level = (processed_input >= min_processing_level) ? processed_input : min_processing_level;
         
         // Convert to logarithmic domain for gain calculation
-        double log_processed = log(processed_input + 1e-30) * LOG_SCALE_FACTOR;
-        double log_final = log(final_level + 1e-30) * LOG_SCALE_FACTOR;
+        double log_processed = CompressorLog(processed_input + 1e-30, fastMath) * LOG_SCALE_FACTOR;
+        double log_final = (final_level == processed_input) ? log_processed
+                         : CompressorLog(final_level + 1e-30, fastMath) * LOG_SCALE_FACTOR;
         
         // Store envelope state for next iteration
         comp->log_envelope = log_final;
+        comp->envelope_level = final_level + 1e-30;
         
         // Calculate gain reduction based on threshold comparison
         double threshold_diff = log_processed - comp->threshold;
         
-        if (threshold_diff <= 0.0) {
+        if (gainTable) {
+            // All three branches below, read from the curve
+            float envelope;
+            final_gain_reduction = LookupGainCurve(comp->gainCurve, (float)threshold_diff, &envelope);
+            if (threshold_diff <= 0.0) comp->processed_envelope = envelope;
+            
+        } else if (threshold_diff <= 0.0) {
             // ================================================================
             // BELOW THRESHOLD - EXPANSION/UPWARD COMPRESSION
             // ================================================================
             
             double expansion_gain = threshold_diff * timeConstant;
-            comp->processed_envelope = exp(expansion_gain);
+            comp->processed_envelope = CompressorExp(expansion_gain, fastMath);
             
             double release_gain = comp->release_time - UNITY_GAIN;
             double final_expansion = release_gain * threshold_diff * timeConstant;
-            final_gain_reduction = exp(final_expansion);
+            final_gain_reduction = CompressorExp(final_expansion, fastMath);
             
             // Apply minimum gain threshold
             if (final_gain_reduction <= MIN_GAIN_THRESHOLD) {
@@ -181,7 +232,7 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
             
             if (threshold_diff <= -NEGATIVE_THRESHOLD) {
                 double standard_compression = threshold_diff * timeConstant;
-                final_gain_reduction = exp(standard_compression);
+                final_gain_reduction = CompressorExp(standard_compression, fastMath);
             } else {
                 // Maximum compression limiting to prevent distortion
                 final_gain_reduction = MIN_GAIN_THRESHOLD;
@@ -202,6 +253,270 @@ double ProcessCompressorBand(CompressorState* comp, double inputPower, double ou
     return processed_output;
 }
 
+// Curves are built for ENVELOPE_TIME_CONSTANT; any other time constant, or
+// a compressor without a curve, runs OTT_MATH_TABLE on the fast formulas
+double ProcessCompressorBand(CompressorState* comp, double inputPower, double outputLevel, 
+                            double bandGain, double timeConstant)
+{
+    if (comp->mathBackend == OTT_MATH_TABLE && comp->gainCurve && timeConstant == ENVELOPE_TIME_CONSTANT) {
+        return ProcessCompressorBandImpl(comp, inputPower, outputLevel, bandGain, timeConstant, true, true);
+    }
+    if (comp->mathBackend != OTT_MATH_LIBM) {
+        return ProcessCompressorBandImpl(comp, inputPower, outputLevel, bandGain, timeConstant, true, false);
+    }
+    return ProcessCompressorBandImpl(comp, inputPower, outputLevel, bandGain, timeConstant, false, false);
+}
+
+// ============================================================================
+// SINGLE-PRECISION COMPRESSOR (OTT_PRECISION_FLOAT)
+// ============================================================================
+
+void LoadCompressorStateF(CompressorStateF* dst, const CompressorState* src)
+{
+    dst->rms_smoother = (float)src->rms_smoother;
+    dst->rms_smoothing_coeff = (float)src->rms_smoothing_coeff;
+    dst->log_envelope = (float)src->log_envelope;
+    dst->threshold = (float)src->threshold;
+    dst->ratio_state = (float)src->ratio_state;
+    dst->gain_reduction = (float)src->gain_reduction;
+    dst->attack_coeff = (float)src->attack_coeff;
+    dst->release_coeff = (float)src->release_coeff;
+    dst->release_time = (float)src->release_time;
+    dst->upward_ratio = (float)src->upward_ratio;
+    dst->envelope_output = (float)src->envelope_output;
+    dst->processed_envelope = (float)src->processed_envelope;
+    dst->envelope_level = (float)src->envelope_level;
+    dst->linear_coeff = src->linear_coeff;
+    dst->knee_coeff = src->knee_coeff;
+    dst->mathBackend = src->mathBackend;
+    dst->gainCurve = src->gainCurve;
+}
+
+// Only the running state goes back; coefficients stay owned by the double
+// struct so a parameter change made between blocks is never overwritten
+void StoreCompressorStateF(CompressorState* dst, const CompressorStateF* src)
+{
+    dst->rms_smoother = src->rms_smoother;
+    dst->log_envelope = src->log_envelope;
+    dst->gain_reduction = src->gain_reduction;
+    dst->envelope_output = src->envelope_output;
+    dst->processed_envelope = src->processed_envelope;
+    dst->envelope_level = src->envelope_level;
+}
+
+static inline float CompressorExpF(float x, bool fastMath)
+{
+    return fastMath ? FastExpF(x) : expf(x);
+}
+
+static inline float CompressorLogF(float x, bool fastMath)
+{
+    return fastMath ? FastLogF(x) : logf(x);
+}
+
+// ProcessCompressorBandImpl in float; see there for what each stage does
+static inline float ProcessCompressorBandFImpl(CompressorStateF* comp, float inputPower, float outputLevel,
+                                               float bandGain, float timeConstant, const bool fastMath,
+                                               const bool gainTable)
+{
+    // RMS detection & smoothing
+    comp->rms_smoother = (comp->rms_smoother - inputPower) * comp->rms_smoothing_coeff + inputPower;
+    
+    float envelope_exp;
+    if (fastMath && timeConstant == (float)ENVELOPE_TIME_CONSTANT) {
+        envelope_exp = comp->envelope_level;
+    } else {
+        envelope_exp = CompressorExpF(comp->log_envelope * timeConstant, fastMath);
+    }
+    float envelope_sqrt = fabsf(sqrtf(comp->rms_smoother));
+    
+    float final_gain_reduction;
+    
+    if (comp->ratio_state <= (float)NEGATIVE_THRESHOLD) {
+        // Main compression path
+        float threshold_value = comp->threshold;
+        
+        float log_input = CompressorLogF(envelope_sqrt + 1e-30f, fastMath) * (float)LOG_SCALE_FACTOR;
+        float max_reduction = fmaxf(0.0f, log_input - threshold_value);
+        
+        float current_ratio = comp->gain_reduction;
+        float compression_coeff = (max_reduction <= current_ratio) ? comp->release_coeff : comp->attack_coeff;
+        float compressed_level = (current_ratio - max_reduction) * compression_coeff + max_reduction;
+        comp->gain_reduction = compressed_level;
+        
+        if (gainTable) {
+            float envelope;
+            final_gain_reduction = LookupGainCurve(comp->gainCurve, compressed_level - threshold_value, &envelope);
+            if (compressed_level > threshold_value) comp->processed_envelope = envelope;
+        } else if (compressed_level <= threshold_value) {
+            float release_factor = comp->release_time - (float)UNITY_GAIN;
+            final_gain_reduction = CompressorExpF(release_factor * compressed_level * timeConstant, fastMath);
+            
+            if (final_gain_reduction <= (float)MIN_GAIN_THRESHOLD) {
+                final_gain_reduction = (float)MIN_GAIN_THRESHOLD;
+            }
+        } else {
+            float gain_multiplier = CompressorExpF((compressed_level - threshold_value) * timeConstant, fastMath);
+            float upward_factor = gain_multiplier * comp->upward_ratio;
+            comp->processed_envelope = gain_multiplier;
+            
+            if (upward_factor <= (float)MAX_COMPRESSION_RATIO) {
+                final_gain_reduction = upward_factor * timeConstant;
+            } else {
+                final_gain_reduction = (float)MAX_COMPRESSION_RATIO * timeConstant;
+            }
+            
+            final_gain_reduction = CompressorExpF(final_gain_reduction, fastMath);
+        }
+        
+    } else {
+        // Alternative processing path (linear/expander mode)
+        float linear_threshold = envelope_exp;
+        float processed_input;
+        
+        if (envelope_sqrt <= linear_threshold) {
+            processed_input = comp->knee_coeff * linear_threshold;
+        } else {
+            processed_input = comp->linear_coeff * (envelope_sqrt - linear_threshold) + linear_threshold;
+        }
+        
+        float final_level = (processed_input >= 1e-30f) ? processed_input : 1e-30f;
+        
+        float log_processed = CompressorLogF(processed_input + 1e-30f, fastMath) * (float)LOG_SCALE_FACTOR;
+        float log_final = (final_level == processed_input) ? log_processed
+                        : CompressorLogF(final_level + 1e-30f, fastMath) * (float)LOG_SCALE_FACTOR;
+        
+        comp->log_envelope = log_final;
+        comp->envelope_level = final_level + 1e-30f;
+        
+        float threshold_diff = log_processed - comp->threshold;
+        
+        if (gainTable) {
+            float envelope;
+            final_gain_reduction = LookupGainCurve(comp->gainCurve, threshold_diff, &envelope);
+            if (threshold_diff <= 0.0f) comp->processed_envelope = envelope;
+        } else if (threshold_diff <= 0.0f) {
+            comp->processed_envelope = CompressorExpF(threshold_diff * timeConstant, fastMath);
+            
+            float release_gain = comp->release_time - (float)UNITY_GAIN;
+            final_gain_reduction = CompressorExpF(release_gain * threshold_diff * timeConstant, fastMath);
+            
+            if (final_gain_reduction <= (float)MIN_GAIN_THRESHOLD) {
+                final_gain_reduction = (float)MIN_GAIN_THRESHOLD;
+            }
+        } else if (threshold_diff <= (float)-NEGATIVE_THRESHOLD) {
+            final_gain_reduction = CompressorExpF(threshold_diff * timeConstant, fastMath);
+        } else {
+            final_gain_reduction = (float)MIN_GAIN_THRESHOLD;
+        }
+    }
+    
+    comp->envelope_output = final_gain_reduction;
+    
+    return final_gain_reduction * outputLevel * bandGain;
+}
+
+float ProcessCompressorBandF(CompressorStateF* comp, float inputPower, float outputLevel,
+                             float bandGain, float timeConstant)
+{
+    if (comp->mathBackend == OTT_MATH_TABLE && comp->gainCurve && timeConstant == (float)ENVELOPE_TIME_CONSTANT) {
+        return ProcessCompressorBandFImpl(comp, inputPower, outputLevel, bandGain, timeConstant, true, true);
+    }
+    if (comp->mathBackend != OTT_MATH_LIBM) {
+        return ProcessCompressorBandFImpl(comp, inputPower, outputLevel, bandGain, timeConstant, true, false);
+    }
+    return ProcessCompressorBandFImpl(comp, inputPower, outputLevel, bandGain, timeConstant, false, false);
+}
+
+// ============================================================================
+// COMPRESSOR BANK LOAD/STORE
+// ============================================================================
+
+// Gather up to four single-precision compressors into the lanes of a bank.
+// Unused lanes mirror the first used lane so they never send the bank down
+// a branch that no real band takes.
+void LoadCompressorBank(CompressorBank* bank, CompressorStateF* const lanes[4])
+{
+    float rms[4], rmsCoeff[4], logEnv[4], threshold[4], ratio[4], gainRed[4], attack[4], release[4];
+    float releaseTime[4], upward[4], envOut[4], procEnv[4], envLevel[4], linear[4], knee[4];
+    
+    const CompressorStateF* firstUsed = NULL;
+    for (int lane = 3; lane >= 0; lane--) {
+        if (lanes[lane]) firstUsed = lanes[lane];
+    }
+    
+    for (int lane = 0; lane < 4; lane++) {
+        const CompressorStateF* comp = lanes[lane] ? lanes[lane] : firstUsed;
+        
+        rms[lane] = comp->rms_smoother;
+        rmsCoeff[lane] = comp->rms_smoothing_coeff;
+        logEnv[lane] = comp->log_envelope;
+        threshold[lane] = comp->threshold;
+        ratio[lane] = comp->ratio_state;
+        gainRed[lane] = comp->gain_reduction;
+        attack[lane] = comp->attack_coeff;
+        release[lane] = comp->release_coeff;
+        releaseTime[lane] = comp->release_time;
+        upward[lane] = comp->upward_ratio;
+        envOut[lane] = comp->envelope_output;
+        procEnv[lane] = comp->processed_envelope;
+        envLevel[lane] = comp->envelope_level;
+        linear[lane] = comp->linear_coeff;
+        knee[lane] = comp->knee_coeff;
+    }
+    
+    bank->fastMath = firstUsed->mathBackend != OTT_MATH_LIBM;
+    bank->gainTable = firstUsed->mathBackend == OTT_MATH_TABLE;
+    for (int lane = 0; lane < 4; lane++) {
+        bank->gainCurves[lane] = lanes[lane] ? lanes[lane]->gainCurve : firstUsed->gainCurve;
+        bank->gainTable = bank->gainTable && bank->gainCurves[lane];
+    }
+    
+    bank->rms_smoother = Vec4Load(rms);
+    bank->rms_smoothing_coeff = Vec4Load(rmsCoeff);
+    bank->log_envelope = Vec4Load(logEnv);
+    bank->threshold = Vec4Load(threshold);
+    bank->ratio_state = Vec4Load(ratio);
+    bank->gain_reduction = Vec4Load(gainRed);
+    bank->attack_coeff = Vec4Load(attack);
+    bank->release_coeff = Vec4Load(release);
+    bank->release_time = Vec4Load(releaseTime);
+    bank->upward_ratio = Vec4Load(upward);
+    bank->envelope_output = Vec4Load(envOut);
+    bank->processed_envelope = Vec4Load(procEnv);
+    bank->envelope_level = Vec4Load(envLevel);
+    bank->linear_coeff = Vec4Load(linear);
+    bank->knee_coeff = Vec4Load(knee);
+    
+    bank->mainPath = Vec4CmpLe(bank->ratio_state, Vec4Splat((float)NEGATIVE_THRESHOLD));
+    bank->mainLanes = Mask4Bits(bank->mainPath);
+}
+
+// Scatter the running state back (coefficients are never modified)
+void StoreCompressorBank(const CompressorBank* bank, CompressorStateF* const lanes[4])
+{
+    float rms[4], logEnv[4], gainRed[4], envOut[4], procEnv[4], envLevel[4];
+    
+    Vec4Store(rms, bank->rms_smoother);
+    Vec4Store(logEnv, bank->log_envelope);
+    Vec4Store(gainRed, bank->gain_reduction);
+    Vec4Store(envOut, bank->envelope_output);
+    Vec4Store(procEnv, bank->processed_envelope);
+    Vec4Store(envLevel, bank->envelope_level);
+    
+    for (int lane = 0; lane < 4; lane++) {
+        CompressorStateF* comp = lanes[lane];
+        if (!comp) continue;
+        
+        comp->rms_smoother = rms[lane];
+        comp->log_envelope = logEnv[lane];
+        comp->gain_reduction = gainRed[lane];
+        comp->envelope_output = envOut[lane];
+        comp->processed_envelope = procEnv[lane];
+        comp->envelope_level = envLevel[lane];
+    }
+}
+
 // ============================================================================
 // COMPRESSOR PARAMETER CONTROL
 // ============================================================================
@@ -219,12 +534,15 @@ void SetCompressorParameters(CompressorState* comp, double threshold, double rat
     // Calculate smoothing coefficient from attack time
     // Faster attack = higher coefficient (more responsive)
     comp->rms_smoothing_coeff = fmin(0.5, attack * 10.0);
+    
+    RefreshGainCurve(comp);
 }
 
 void SetCompressorThreshold(CompressorState* comp, double threshold_db)
 {
     // Convert dB to internal logarithmic representation
     comp->threshold = threshold_db * 0.11512925; // ln(10)/20 for dB conversion
+    RefreshGainCurve(comp);
 }
 
 void SetCompressorRatio(CompressorState* comp, double ratio)
@@ -242,6 +560,15 @@ void SetCompressorRatio(CompressorState* comp, double ratio)
         comp->attack_coeff = 0.1 * ratio;    // Faster attack for expansion
         comp->release_coeff = 0.01 * ratio;  // Faster release for expansion
     }
+    
+    // ratio_state picks the compression path, and with it the curve
+    RefreshGainCurve(comp);
+}
+
+void SetCompressorMathBackend(CompressorState* comp, OTTMathBackend backend)
+{
+    comp->mathBackend = backend;
+    RefreshGainCurve(comp);
 }
 
 void SetCompressorTiming(CompressorState* comp, double attack_ms, double release_ms, double sample_rate)
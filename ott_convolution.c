@@ -0,0 +1,578 @@
+/**
+ * OTT Linear-Phase Crossover
+ * FIR crossover run as uniformly partitioned overlap-save convolution
+ */
+
+#include "ott_plugin.h"
+#include "ott_kernels.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#define LP_BLOCK        OTT_LINEAR_PHASE_BLOCK
+#define LP_PARTITIONS   OTT_LINEAR_PHASE_PARTITIONS
+#define LP_FFT_SIZE     OTT_LINEAR_PHASE_FFT_SIZE
+#define LP_TAPS         OTT_LINEAR_PHASE_TAPS
+
+// ============================================================================
+// BUFFER LAYOUT
+// ============================================================================
+
+static inline size_t AlignConvolutionSize(size_t size)
+{
+    return (size + OTT_CACHE_LINE_SIZE - 1) & ~(size_t)(OTT_CACHE_LINE_SIZE - 1);
+}
+
+// Carves count elements of size bytes off the front of *cursor
+static void* TakeConvolutionBuffer(char** cursor, size_t* offset, size_t count, size_t size)
+{
+    void* buffer = *cursor ? *cursor + *offset : NULL;
+    *offset += AlignConvolutionSize(count * size);
+    return buffer;
+}
+
+/*
+ * Lays out the buffers for crossover->maxPoints crossover points in memory
+ * and returns their size, a whole number of cache lines (none without
+ * points). With memory == NULL only the size is computed.
+ */
+size_t BindLinearPhaseCrossover(LinearPhaseCrossover* crossover, void* memory)
+{
+    const size_t points = crossover->maxPoints;
+    if (!points) return 0;
+    
+    uint32_t drySize = 1;
+    while (drySize <= OTT_LINEAR_PHASE_LATENCY) drySize <<= 1;
+    
+    char* cursor = (char*)memory;
+    size_t offset = 0;
+    float* kernelRe[2];
+    float* kernelIm[2];
+    for (int bank = 0; bank < 2; bank++) {
+        kernelRe[bank] = TakeConvolutionBuffer(&cursor, &offset, points * LP_PARTITIONS * LP_FFT_SIZE, sizeof(float));
+        kernelIm[bank] = TakeConvolutionBuffer(&cursor, &offset, points * LP_PARTITIONS * LP_FFT_SIZE, sizeof(float));
+    }
+    float* spectraRe = TakeConvolutionBuffer(&cursor, &offset, LP_PARTITIONS * LP_FFT_SIZE, sizeof(float));
+    float* spectraIm = TakeConvolutionBuffer(&cursor, &offset, LP_PARTITIONS * LP_FFT_SIZE, sizeof(float));
+    float* windowRe = TakeConvolutionBuffer(&cursor, &offset, LP_FFT_SIZE, sizeof(float));
+    float* windowIm = TakeConvolutionBuffer(&cursor, &offset, LP_FFT_SIZE, sizeof(float));
+    float* scratchRe = TakeConvolutionBuffer(&cursor, &offset, LP_FFT_SIZE, sizeof(float));
+    float* scratchIm = TakeConvolutionBuffer(&cursor, &offset, LP_FFT_SIZE, sizeof(float));
+    float* outputRe = TakeConvolutionBuffer(&cursor, &offset, points * LP_BLOCK, sizeof(float));
+    float* outputIm = TakeConvolutionBuffer(&cursor, &offset, points * LP_BLOCK, sizeof(float));
+    float* dryLeft = TakeConvolutionBuffer(&cursor, &offset, drySize, sizeof(float));
+    float* dryRight = TakeConvolutionBuffer(&cursor, &offset, drySize, sizeof(float));
+    float* taps = TakeConvolutionBuffer(&cursor, &offset, LP_TAPS, sizeof(float));
+    
+    if (!memory) return offset;
+    
+    for (int bank = 0; bank < 2; bank++) {
+        crossover->kernelRe[bank] = kernelRe[bank];
+        crossover->kernelIm[bank] = kernelIm[bank];
+    }
+    crossover->spectraRe = spectraRe;
+    crossover->spectraIm = spectraIm;
+    crossover->windowRe = windowRe;
+    crossover->windowIm = windowIm;
+    crossover->scratchRe = scratchRe;
+    crossover->scratchIm = scratchIm;
+    crossover->outputRe = outputRe;
+    crossover->outputIm = outputIm;
+    crossover->dryLeft = dryLeft;
+    crossover->dryRight = dryRight;
+    crossover->taps = taps;
+    crossover->dryMask = drySize - 1;
+    return offset;
+}
+
+// ============================================================================
+// SHARED PLAN
+// ============================================================================
+
+// The FFT plan and the kernel window depend on nothing but the constants,
+// so one copy serves every instance
+typedef struct {
+    uint32_t bitReverse[LP_FFT_SIZE];   // Input permutation
+    float twiddleRe[LP_FFT_SIZE / 2];   // exp(-2 pi i k / FFT_SIZE), k < FFT_SIZE / 2
+    float twiddleIm[LP_FFT_SIZE / 2];
+    float taper[LP_TAPS];               // Blackman window over the kernel taps
+} LinearPhasePlan;
+
+enum {
+    LP_PLAN_EMPTY = 0,
+    LP_PLAN_BUILDING,
+    LP_PLAN_READY
+};
+
+static LinearPhasePlan LinearPhasePlanTable;
+static _Atomic uint32_t LinearPhasePlanState;
+
+// Blackman window over the kernel
+static inline float LinearPhaseTaper(int n)
+{
+    double phase = 2.0 * OTT_PI * n / (LP_TAPS - 1);
+    return (float)(0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase));
+}
+
+// Builds the plan on first use, published like the coefficient caches'
+// slots. A caller that finds it being built waits: binding an arena is
+// never on the audio thread.
+static void BuildLinearPhasePlan(void)
+{
+    uint32_t expected = LP_PLAN_EMPTY;
+    if (!atomic_compare_exchange_strong_explicit(&LinearPhasePlanState, &expected, LP_PLAN_BUILDING,
+                                                 memory_order_acquire, memory_order_acquire)) {
+        while (atomic_load_explicit(&LinearPhasePlanState, memory_order_acquire) != LP_PLAN_READY) {
+        }
+        return;
+    }
+    
+    LinearPhasePlan* plan = &LinearPhasePlanTable;
+    int bits = 0;
+    while ((1 << bits) < LP_FFT_SIZE) bits++;
+    for (uint32_t i = 0; i < LP_FFT_SIZE; i++) {
+        uint32_t reversed = 0;
+        for (int bit = 0; bit < bits; bit++) {
+            reversed |= ((i >> bit) & 1u) << (bits - 1 - bit);
+        }
+        plan->bitReverse[i] = reversed;
+    }
+    for (int k = 0; k < LP_FFT_SIZE / 2; k++) {
+        double angle = 2.0 * OTT_PI * k / LP_FFT_SIZE;
+        plan->twiddleRe[k] = (float)cos(angle);
+        plan->twiddleIm[k] = (float)-sin(angle);
+    }
+    for (int n = 0; n < LP_TAPS; n++) {
+        plan->taper[n] = LinearPhaseTaper(n);
+    }
+    
+    atomic_store_explicit(&LinearPhasePlanState, LP_PLAN_READY, memory_order_release);
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+// Shared plan, then a clear. The kernel banks survive a (re)bind along
+// with the header, so binding the same arena again costs no redesign.
+void PrepareLinearPhaseCrossover(LinearPhaseCrossover* crossover)
+{
+    if (!crossover->maxPoints) return;
+    
+    if (atomic_load_explicit(&LinearPhasePlanState, memory_order_acquire) != LP_PLAN_READY) {
+        BuildLinearPhasePlan();
+    }
+    ClearLinearPhaseCrossover(crossover);
+}
+
+/*
+ * Silence in, silence out, in constant time: only the window is zeroed.
+ * Input spectra, lowpass outputs and dry slots written before the clear
+ * sit behind the validBlocks / dryFilled watermarks and read as zero until
+ * they are overwritten. The kernels are kept.
+ */
+void ClearLinearPhaseCrossover(LinearPhaseCrossover* crossover)
+{
+    if (!crossover->maxPoints) return;
+    
+    memset(crossover->windowRe, 0, LP_FFT_SIZE * sizeof(float));
+    memset(crossover->windowIm, 0, LP_FFT_SIZE * sizeof(float));
+    crossover->dryIndex = 0;
+    crossover->dryFilled = 0;
+    crossover->fill = 0;
+    crossover->head = 0;
+    crossover->validBlocks = 0;
+    crossover->silentBlocks = LP_PARTITIONS + 1;
+}
+
+// ============================================================================
+// FFT
+// ============================================================================
+
+// In-place radix-2 transform of LP_FFT_SIZE split complex values. The
+// inverse is unscaled; the kernels carry the 1 / LP_FFT_SIZE.
+static void TransformLinearPhase(float* re, float* im, bool inverse)
+{
+    const LinearPhasePlan* plan = &LinearPhasePlanTable;
+    for (uint32_t i = 0; i < LP_FFT_SIZE; i++) {
+        uint32_t j = plan->bitReverse[i];
+        if (j > i) {
+            float swapRe = re[i], swapIm = im[i];
+            re[i] = re[j];
+            im[i] = im[j];
+            re[j] = swapRe;
+            im[j] = swapIm;
+        }
+    }
+    
+    const float direction = inverse ? -1.0f : 1.0f;
+    for (uint32_t size = 2; size <= LP_FFT_SIZE; size <<= 1) {
+        const uint32_t half = size / 2;
+        const uint32_t stride = LP_FFT_SIZE / size;
+        for (uint32_t start = 0; start < LP_FFT_SIZE; start += size) {
+            for (uint32_t k = 0; k < half; k++) {
+                float wr = plan->twiddleRe[k * stride];
+                float wi = plan->twiddleIm[k * stride] * direction;
+                uint32_t a = start + k, b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// KERNEL DESIGN
+// ============================================================================
+
+// Hand-over of the spare kernel bank between the parameter thread and the
+// engines
+enum {
+    LP_KERNELS_IDLE = 0,    // Spare bank free for the parameter thread
+    LP_KERNELS_DESIGNING,   // Parameter thread writing the spare bank
+    LP_KERNELS_READY,       // Spare bank waiting for the next block start
+    LP_KERNELS_SWAPPING     // Engines swapping banks
+};
+
+// Windowed-sinc lowpass taps at frequency, before normalization; returns
+// their sum
+static double DesignLinearPhaseTaps(float* taps, float frequency, float sampleRate)
+{
+    const float* taper = LinearPhasePlanTable.taper;
+    const double cutoff = fmin(frequency / sampleRate, 0.49);
+    const int center = LP_TAPS / 2;
+    
+    double sum = 0.0;
+    for (int n = 0; n < LP_TAPS; n++) {
+        double x = n - center;
+        double sinc = (x == 0.0) ? 2.0 * cutoff : sin(2.0 * OTT_PI * cutoff * x) / (OTT_PI * x);
+        taps[n] = (float)(sinc * taper[n]);
+        sum += taps[n];
+    }
+    return sum;
+}
+
+// Windowed-sinc lowpass at frequency, normalized to unity gain at DC, as
+// partition spectra in bank
+static void DesignLinearPhaseKernel(LinearPhaseCrossover* crossover, uint32_t bank, int point, float frequency,
+                                    float sampleRate)
+{
+    float* taps = crossover->taps;
+    const double sum = DesignLinearPhaseTaps(taps, frequency, sampleRate);
+    
+    const float scale = (float)(1.0 / (sum * LP_FFT_SIZE));
+    for (int partition = 0; partition < LP_PARTITIONS; partition++) {
+        float* re = crossover->kernelRe[bank] + ((size_t)point * LP_PARTITIONS + partition) * LP_FFT_SIZE;
+        float* im = crossover->kernelIm[bank] + ((size_t)point * LP_PARTITIONS + partition) * LP_FFT_SIZE;
+        for (int i = 0; i < LP_FFT_SIZE; i++) {
+            int n = partition * LP_BLOCK + i;
+            re[i] = (i < LP_BLOCK && n < LP_TAPS) ? taps[n] * scale : 0.0f;
+            im[i] = 0.0f;
+        }
+        TransformLinearPhase(re, im, false);
+    }
+}
+
+static bool LinearPhaseKernelsMatch(const LinearPhaseCrossover* crossover, uint32_t bank, int points,
+                                    const float* frequencies, float sampleRate)
+{
+    if (crossover->kernelSampleRate[bank] != sampleRate) return false;
+    for (int point = 0; point < points; point++) {
+        if (crossover->kernelFrequencies[bank][point] != frequencies[point]) return false;
+    }
+    return true;
+}
+
+/*
+ * Parameter thread: designs kernels for frequencies at sampleRate into the
+ * spare bank, only for the points it doesn't already hold (all of them
+ * after a rate change), and hands the bank over. The engines swap it in at
+ * the next block start, so the new kernels apply from the next partition
+ * on, with no glide. A bank handed over but not yet swapped in is taken
+ * back and brought up to date; nothing is handed over when the active bank
+ * already matches.
+ */
+void DesignLinearPhaseKernels(LinearPhaseCrossover* crossover, int numBands, const float* frequencies,
+                              float sampleRate)
+{
+    if (!crossover->maxPoints) return;
+    
+    // A swap takes the engines a few instructions; wait it out
+    uint32_t state = atomic_load_explicit(&crossover->kernelState, memory_order_acquire);
+    do {
+        while (state == LP_KERNELS_SWAPPING) {
+            state = atomic_load_explicit(&crossover->kernelState, memory_order_acquire);
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&crossover->kernelState, &state, LP_KERNELS_DESIGNING,
+                                                    memory_order_acquire, memory_order_acquire));
+    
+    const int points = numBands - 1;
+    const uint32_t active = crossover->activeKernels;
+    if (LinearPhaseKernelsMatch(crossover, active, points, frequencies, sampleRate)) {
+        atomic_store_explicit(&crossover->kernelState, LP_KERNELS_IDLE, memory_order_release);
+        return;
+    }
+    
+    const uint32_t spare = active ^ 1;
+    const bool redesign = crossover->kernelSampleRate[spare] != sampleRate;
+    for (int point = 0; point < points; point++) {
+        if (!redesign && crossover->kernelFrequencies[spare][point] == frequencies[point]) continue;
+        DesignLinearPhaseKernel(crossover, spare, point, frequencies[point], sampleRate);
+        crossover->kernelFrequencies[spare][point] = frequencies[point];
+    }
+    crossover->kernelSampleRate[spare] = sampleRate;
+    atomic_store_explicit(&crossover->kernelState, LP_KERNELS_READY, memory_order_release);
+}
+
+// Engines, at block start: swaps in a bank the parameter thread handed over
+void SwapLinearPhaseKernels(LinearPhaseCrossover* crossover)
+{
+    uint32_t expected = LP_KERNELS_READY;
+    if (atomic_load_explicit(&crossover->kernelState, memory_order_relaxed) != LP_KERNELS_READY) return;
+    if (!atomic_compare_exchange_strong_explicit(&crossover->kernelState, &expected, LP_KERNELS_SWAPPING,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        return;
+    }
+    crossover->activeKernels ^= 1;
+    atomic_store_explicit(&crossover->kernelState, LP_KERNELS_IDLE, memory_order_release);
+}
+
+// ============================================================================
+// CONVOLUTION
+// ============================================================================
+
+// One full block: transform the window, then per point multiply-accumulate
+// every partition against the matching input spectrum and keep the last
+// LP_BLOCK samples of the inverse. Spectra from before the last clear count
+// as zero and are skipped.
+static void ProcessLinearPhaseBlock(LinearPhaseCrossover* crossover, int points)
+{
+    float* windowRe = crossover->windowRe;
+    float* windowIm = crossover->windowIm;
+    
+    bool silent = true;
+    for (int i = LP_BLOCK; i < LP_FFT_SIZE; i++) {
+        silent = silent && windowRe[i] == 0.0f && windowIm[i] == 0.0f;
+    }
+    if (!silent) {
+        crossover->silentBlocks = 0;
+    } else if (crossover->silentBlocks <= LP_PARTITIONS) {
+        crossover->silentBlocks++;
+    }
+    
+    const uint32_t head = (crossover->head + 1) % LP_PARTITIONS;
+    float* inputRe = crossover->spectraRe + (size_t)head * LP_FFT_SIZE;
+    float* inputIm = crossover->spectraIm + (size_t)head * LP_FFT_SIZE;
+    memcpy(inputRe, windowRe, LP_FFT_SIZE * sizeof(float));
+    memcpy(inputIm, windowIm, LP_FFT_SIZE * sizeof(float));
+    TransformLinearPhase(inputRe, inputIm, false);
+    crossover->head = head;
+    if (crossover->validBlocks < LP_PARTITIONS) crossover->validBlocks++;
+    const uint32_t partitions = crossover->validBlocks;
+    
+    // The block being filled becomes the previous block
+    memcpy(windowRe, windowRe + LP_BLOCK, LP_BLOCK * sizeof(float));
+    memcpy(windowIm, windowIm + LP_BLOCK, LP_BLOCK * sizeof(float));
+    
+    const float* kernelRe = crossover->kernelRe[crossover->activeKernels];
+    const float* kernelIm = crossover->kernelIm[crossover->activeKernels];
+    float* accRe = crossover->scratchRe;
+    float* accIm = crossover->scratchIm;
+    for (int point = 0; point < points; point++) {
+        memset(accRe, 0, LP_FFT_SIZE * sizeof(float));
+        memset(accIm, 0, LP_FFT_SIZE * sizeof(float));
+        
+        for (uint32_t partition = 0; partition < partitions; partition++) {
+            const uint32_t slot = (head + LP_PARTITIONS - partition) % LP_PARTITIONS;
+            const float* xRe = crossover->spectraRe + (size_t)slot * LP_FFT_SIZE;
+            const float* xIm = crossover->spectraIm + (size_t)slot * LP_FFT_SIZE;
+            const float* hRe = kernelRe + ((size_t)point * LP_PARTITIONS + partition) * LP_FFT_SIZE;
+            const float* hIm = kernelIm + ((size_t)point * LP_PARTITIONS + partition) * LP_FFT_SIZE;
+            for (int bin = 0; bin < LP_FFT_SIZE; bin += 4) {
+                OTTVec4 ar = Vec4Load(xRe + bin), ai = Vec4Load(xIm + bin);
+                OTTVec4 br = Vec4Load(hRe + bin), bi = Vec4Load(hIm + bin);
+                Vec4Store(accRe + bin, Vec4Add(Vec4Load(accRe + bin), Vec4Sub(Vec4Mul(ar, br), Vec4Mul(ai, bi))));
+                Vec4Store(accIm + bin, Vec4Add(Vec4Load(accIm + bin), Vec4Add(Vec4Mul(ar, bi), Vec4Mul(ai, br))));
+            }
+        }
+        
+        TransformLinearPhase(accRe, accIm, true);
+        memcpy(crossover->outputRe + (size_t)point * LP_BLOCK, accRe + LP_BLOCK, LP_BLOCK * sizeof(float));
+        memcpy(crossover->outputIm + (size_t)point * LP_BLOCK, accIm + LP_BLOCK, LP_BLOCK * sizeof(float));
+    }
+}
+
+/*
+ * One stereo sample in, one sample of every band out, OTT_LINEAR_PHASE_LATENCY
+ * samples late. Bands come from the last block's lowpass outputs and the
+ * dry line; every LP_BLOCK samples the new block is convolved. Until the
+ * first block after a clear the outputs read as zero, and so does the dry
+ * line until the latency has been written.
+ */
+void ProcessLinearPhaseCrossover(LinearPhaseCrossover* crossover, int numBands, float left, float right,
+                                 float* bands)
+{
+    const int points = numBands - 1;
+    const uint32_t fill = crossover->fill;
+    const bool convolved = crossover->validBlocks != 0;
+    
+    float lowerLeft = 0.0f, lowerRight = 0.0f;
+    for (int point = 0; point < points; point++) {
+        float lowLeft = convolved ? crossover->outputRe[point * LP_BLOCK + fill] : 0.0f;
+        float lowRight = convolved ? crossover->outputIm[point * LP_BLOCK + fill] : 0.0f;
+        bands[2 * point] = lowLeft - lowerLeft;
+        bands[2 * point + 1] = lowRight - lowerRight;
+        lowerLeft = lowLeft;
+        lowerRight = lowRight;
+    }
+    
+    const uint32_t dryIndex = crossover->dryIndex;
+    const uint32_t dryRead = (dryIndex - OTT_LINEAR_PHASE_LATENCY) & crossover->dryMask;
+    const bool dryFull = crossover->dryFilled == OTT_LINEAR_PHASE_LATENCY;
+    bands[2 * points] = (dryFull ? crossover->dryLeft[dryRead] : 0.0f) - lowerLeft;
+    bands[2 * points + 1] = (dryFull ? crossover->dryRight[dryRead] : 0.0f) - lowerRight;
+    crossover->dryLeft[dryIndex] = left;
+    crossover->dryRight[dryIndex] = right;
+    crossover->dryIndex = (dryIndex + 1) & crossover->dryMask;
+    crossover->dryFilled += !dryFull;
+    
+    crossover->windowRe[LP_BLOCK + fill] = left;
+    crossover->windowIm[LP_BLOCK + fill] = right;
+    if (fill + 1 == LP_BLOCK) {
+        ProcessLinearPhaseBlock(crossover, points);
+        crossover->fill = 0;
+    } else {
+        crossover->fill = fill + 1;
+    }
+}
+
+// True once every input the outputs and the dry line can still reach is
+// zero: LP_PARTITIONS + 1 silent blocks and a silent partial block
+bool LinearPhaseCrossoverAtRest(const LinearPhaseCrossover* crossover)
+{
+    if (crossover->silentBlocks <= LP_PARTITIONS) return false;
+    
+    for (uint32_t i = 0; i < crossover->fill; i++) {
+        if (crossover->windowRe[LP_BLOCK + i] != 0.0f || crossover->windowIm[LP_BLOCK + i] != 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Moves a crossover at rest on by samples of silence without running it.
+// Everything the outputs can still reach is zero, so only the block phase
+// moves and the skipped dry line slots are zeroed, as running the silence
+// through would leave them.
+void SkipLinearPhaseCrossover(LinearPhaseCrossover* crossover, uint32_t samples)
+{
+    if (!crossover->maxPoints) return;
+    
+    const uint32_t slots = samples <= crossover->dryMask ? samples : crossover->dryMask + 1;
+    for (uint32_t i = 0; i < slots; i++) {
+        uint32_t index = (crossover->dryIndex + i) & crossover->dryMask;
+        crossover->dryLeft[index] = 0.0f;
+        crossover->dryRight[index] = 0.0f;
+    }
+    crossover->fill = (crossover->fill + samples) % LP_BLOCK;
+    crossover->dryIndex = (crossover->dryIndex + samples) & crossover->dryMask;
+    crossover->dryFilled = (samples < OTT_LINEAR_PHASE_LATENCY - crossover->dryFilled)
+                               ? crossover->dryFilled + samples : OTT_LINEAR_PHASE_LATENCY;
+}
+
+// ============================================================================
+// RESPONSE
+// ============================================================================
+
+// Taps between reseeds of the series recurrence, and frequencies run per
+// pass over the series
+#define LP_RESPONSE_RESEED  64
+#define LP_RESPONSE_TILE    16
+
+/*
+ * Amplitude of the lowpass kernel DesignLinearPhaseKernel makes for
+ * frequency at the count frequencies startHz + i * stepHz. Every band is
+ * the difference of two of these (or of 1 and one), delayed by
+ * OTT_LINEAR_PHASE_LATENCY. The kernel is folded about its center and run
+ * as a cosine series with the lanes along frequency. cos/sin(m w) advance
+ * by rotation in float and are reseeded every LP_RESPONSE_RESEED taps from
+ * a rotation in double. With the tap design that is far more work than
+ * the IIR networks take, so callers should keep the result until the
+ * points move. The taps go through crossover's design scratch, so this
+ * runs on the parameter thread, like DesignLinearPhaseKernels.
+ */
+void LinearPhaseLowpassAmplitude(LinearPhaseCrossover* crossover, float frequency, float sampleRate,
+                                 float startHz, float stepHz, int32_t count, float* amplitude)
+{
+    const int center = LP_TAPS / 2;
+    float* taps = crossover->taps;
+    const float scale = (float)(1.0 / DesignLinearPhaseTaps(taps, frequency, sampleRate));
+    
+    // Folded in place: series[0] = h[c], series[m] = h[c + m] + h[c - m]
+    float* series = taps + center;
+    series[0] *= scale;
+    for (int m = 1; m <= center; m++) {
+        series[m] = (series[m] + taps[center - m]) * scale;
+    }
+    
+    for (int32_t tile = 0; tile < count; tile += LP_RESPONSE_TILE) {
+        // Seeds e^(j m w) advance in double, LP_RESPONSE_RESEED taps at a time
+        double seedRe[LP_RESPONSE_TILE], seedIm[LP_RESPONSE_TILE];
+        double jumpRe[LP_RESPONSE_TILE], jumpIm[LP_RESPONSE_TILE];
+        float stepRe[LP_RESPONSE_TILE], stepIm[LP_RESPONSE_TILE];
+        for (int i = 0; i < LP_RESPONSE_TILE; i++) {
+            double omega = 2.0 * OTT_PI * (startHz + (double)(tile + i) * stepHz) / sampleRate;
+            seedRe[i] = cos(omega);
+            seedIm[i] = sin(omega);
+            jumpRe[i] = cos(LP_RESPONSE_RESEED * omega);
+            jumpIm[i] = sin(LP_RESPONSE_RESEED * omega);
+            stepRe[i] = (float)seedRe[i];
+            stepIm[i] = (float)seedIm[i];
+        }
+        
+        // LP_RESPONSE_TILE / 4 independent rotations per tap hide each
+        // other's latency
+        enum { GROUPS = LP_RESPONSE_TILE / 4 };
+        OTTVec4 re[GROUPS], im[GROUPS], sum[GROUPS];
+        for (int g = 0; g < GROUPS; g++) {
+            sum[g] = Vec4Splat(series[0]);
+        }
+        for (int m = 1; m <= center; m++) {
+            if ((m - 1) % LP_RESPONSE_RESEED == 0) {
+                float seedLaneRe[LP_RESPONSE_TILE], seedLaneIm[LP_RESPONSE_TILE];
+                for (int i = 0; i < LP_RESPONSE_TILE; i++) {
+                    seedLaneRe[i] = (float)seedRe[i];
+                    seedLaneIm[i] = (float)seedIm[i];
+                    double nextRe = seedRe[i] * jumpRe[i] - seedIm[i] * jumpIm[i];
+                    seedIm[i] = seedRe[i] * jumpIm[i] + seedIm[i] * jumpRe[i];
+                    seedRe[i] = nextRe;
+                }
+                for (int g = 0; g < GROUPS; g++) {
+                    re[g] = Vec4Load(seedLaneRe + 4 * g);
+                    im[g] = Vec4Load(seedLaneIm + 4 * g);
+                }
+            } else {
+                for (int g = 0; g < GROUPS; g++) {
+                    OTTVec4 rotateRe = Vec4Load(stepRe + 4 * g), rotateIm = Vec4Load(stepIm + 4 * g);
+                    OTTVec4 nextRe = Vec4Sub(Vec4Mul(re[g], rotateRe), Vec4Mul(im[g], rotateIm));
+                    im[g] = Vec4Add(Vec4Mul(re[g], rotateIm), Vec4Mul(im[g], rotateRe));
+                    re[g] = nextRe;
+                }
+            }
+            const OTTVec4 weight = Vec4Splat(series[m]);
+            for (int g = 0; g < GROUPS; g++) {
+                sum[g] = Vec4Add(sum[g], Vec4Mul(weight, re[g]));
+            }
+        }
+        
+        float amplitudes[LP_RESPONSE_TILE];
+        for (int g = 0; g < GROUPS; g++) {
+            Vec4Store(amplitudes + 4 * g, sum[g]);
+        }
+        const int32_t frequencies = (count - tile < LP_RESPONSE_TILE) ? count - tile : LP_RESPONSE_TILE;
+        memcpy(amplitude + tile, amplitudes, frequencies * sizeof(float));
+    }
+}
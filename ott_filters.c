@@ -4,6 +4,8 @@
  */
 
 #include "ott_plugin.h"
+#include "ott_kernels.h"
+#include <string.h>
 
 // ============================================================================
 // BIQUAD FILTER PROCESSING (Direct Form II)
@@ -42,6 +44,186 @@ float ProcessBiquadFilter(BiquadFilter* filter, float input)
     return output;
 }
 
+// ============================================================================
+// BLOCK-PARALLEL BIQUAD (STATE-SPACE LOOK-AHEAD)
+// ============================================================================
+
+/*
+ * ProcessBiquadFilter is a linear recurrence on s = (state1, state2):
+ *   v  = a1 s1 - a2 s2 + a2 x           (intermediate)
+ *   lp = a2 s1 + (1 - b2) s2 + b2 x     (output)
+ *   s' = (2 v - s1, 2 lp - s2)
+ * that is s' = A s + B x, with taps C s + D x. Unrolled four samples
+ * ahead, every tap of samples n..n+3 follows from s[n] and x[n..n+3]
+ * alone, so they are computed with the vector lanes along time, and
+ * s[n+4] = A^4 s[n] + sum_j A^(3-j) B x[n+j] is the only serial step left.
+ * The matrices are built in double from the section's coefficients; the
+ * outputs match the serial recurrence to float rounding.
+ */
+static void BuildBiquadBlockKernel(BiquadBlockKernel* kernel, const BiquadFilter* filter)
+{
+    const double a1 = filter->coeff_a1, a2 = filter->coeff_a2, b2 = filter->coeff_b2;
+    const double A[2][2] = { { 2.0 * a1 - 1.0, -2.0 * a2 }, { 2.0 * a2, 1.0 - 2.0 * b2 } };
+    const double B[2] = { 2.0 * a2, 2.0 * b2 };
+    const double C[2][2] = { { a1, -a2 }, { a2, 1.0 - b2 } };   // Rows: v, lp
+    const double D[2] = { a2, b2 };
+    
+    // power[k] = A^k, k = 0..4
+    double power[5][2][2] = { { { 1.0, 0.0 }, { 0.0, 1.0 } } };
+    for (int k = 1; k <= 4; k++) {
+        for (int row = 0; row < 2; row++) {
+            for (int col = 0; col < 2; col++) {
+                power[k][row][col] = A[row][0] * power[k - 1][0][col] + A[row][1] * power[k - 1][1][col];
+            }
+        }
+    }
+    
+    // Per tap row: C A^k, and C A^m B
+    float state[2][2][4], input[2][4][4];
+    for (int tap = 0; tap < 2; tap++) {
+        for (int k = 0; k < 4; k++) {
+            for (int col = 0; col < 2; col++) {
+                state[tap][col][k] = (float)(C[tap][0] * power[k][0][col] + C[tap][1] * power[k][1][col]);
+            }
+            for (int j = 0; j < 4; j++) {
+                double gain = 0.0;
+                if (j == k) {
+                    gain = D[tap];
+                } else if (j < k) {
+                    const int m = k - 1 - j;
+                    gain = C[tap][0] * (power[m][0][0] * B[0] + power[m][0][1] * B[1]) +
+                           C[tap][1] * (power[m][1][0] * B[0] + power[m][1][1] * B[1]);
+                }
+                input[tap][j][k] = (float)gain;
+            }
+        }
+    }
+    
+    for (int col = 0; col < 2; col++) {
+        kernel->intermediateState[col] = Vec4Load(state[0][col]);
+        kernel->outputState[col] = Vec4Load(state[1][col]);
+    }
+    for (int j = 0; j < 4; j++) {
+        kernel->intermediateInput[j] = Vec4Load(input[0][j]);
+        kernel->outputInput[j] = Vec4Load(input[1][j]);
+    }
+    for (int row = 0; row < 2; row++) {
+        kernel->stateState[row][0] = (float)power[4][row][0];
+        kernel->stateState[row][1] = (float)power[4][row][1];
+        for (int j = 0; j < 4; j++) {
+            kernel->stateInput[row][j] = (float)(power[3 - j][row][0] * B[0] + power[3 - j][row][1] * B[1]);
+        }
+    }
+}
+
+// ProcessBiquadFilterBlock on a kernel built from the filter's current
+// coefficients
+static void RunBiquadFilterBlock(BiquadFilter* filter, const BiquadBlockKernel* kernel, const float* input,
+                                 float* lowpass, float* highpass, int64_t numSamples)
+{
+    int64_t sampleIdx = 0;
+    
+    if (numSamples > 4) {
+        const OTTVec4 b1 = Vec4Splat(filter->b1);
+        float s1 = filter->state1;
+        float s2 = filter->state2;
+        
+        for (; sampleIdx + 4 < numSamples; sampleIdx += 4) {
+            const float* x = input + sampleIdx;
+            const float x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3];
+            const OTTVec4 samples = Vec4Load(x);
+            const OTTVec4 xs[4] = { Vec4Splat(x0), Vec4Splat(x1), Vec4Splat(x2), Vec4Splat(x3) };
+            const OTTVec4 state1 = Vec4Splat(s1), state2 = Vec4Splat(s2);
+            
+            OTTVec4 v = Vec4Add(Vec4Mul(kernel->intermediateState[0], state1),
+                                Vec4Mul(kernel->intermediateState[1], state2));
+            OTTVec4 lp = Vec4Add(Vec4Mul(kernel->outputState[0], state1), Vec4Mul(kernel->outputState[1], state2));
+            for (int j = 0; j < 4; j++) {
+                v = Vec4Add(v, Vec4Mul(kernel->intermediateInput[j], xs[j]));
+                lp = Vec4Add(lp, Vec4Mul(kernel->outputInput[j], xs[j]));
+            }
+            
+            float next1 = kernel->stateState[0][0] * s1 + kernel->stateState[0][1] * s2;
+            float next2 = kernel->stateState[1][0] * s1 + kernel->stateState[1][1] * s2;
+            next1 += kernel->stateInput[0][0] * x0 + kernel->stateInput[0][1] * x1 +
+                     kernel->stateInput[0][2] * x2 + kernel->stateInput[0][3] * x3;
+            next2 += kernel->stateInput[1][0] * x0 + kernel->stateInput[1][1] * x1 +
+                     kernel->stateInput[1][2] * x2 + kernel->stateInput[1][3] * x3;
+            s1 = next1;
+            s2 = next2;
+            
+            // Same operation order as GetBiquadHighpass
+            if (highpass) Vec4Store(highpass + sampleIdx, Vec4Sub(Vec4Sub(samples, Vec4Mul(v, b1)), lp));
+            if (lowpass) Vec4Store(lowpass + sampleIdx, lp);
+        }
+        
+        filter->state1 = s1;
+        filter->state2 = s2;
+    }
+    
+    for (; sampleIdx < numSamples; sampleIdx++) {
+        float output = ProcessBiquadFilter(filter, input[sampleIdx]);
+        if (highpass) highpass[sampleIdx] = GetBiquadHighpass(filter);
+        if (lowpass) lowpass[sampleIdx] = output;
+    }
+}
+
+/*
+ * Runs one section over numSamples of input, writing its lowpass and/or
+ * highpass (either may be NULL, either may be input). The last sample
+ * always goes through ProcessBiquadFilter, so the filter's taps end up as
+ * after a serial run.
+ */
+void ProcessBiquadFilterBlock(BiquadFilter* filter, const float* input, float* lowpass, float* highpass,
+                              int64_t numSamples)
+{
+    BiquadBlockKernel kernel;
+    if (numSamples > 4) BuildBiquadBlockKernel(&kernel, filter);
+    RunBiquadFilterBlock(filter, &kernel, input, lowpass, highpass, numSamples);
+}
+
+/*
+ * Whether a chunk's legacy crossover runs through the block kernel. The
+ * six kernels are built once per chunk, which the look-ahead earns back
+ * against ProcessBiquadFilter within about 40 samples, so shorter chunks
+ * stay serial. The rule doesn't depend on the engine, so the staged and
+ * fused engines still agree sample for sample whichever kernel is set.
+ */
+bool UseLegacyBlockKernel(OTTFilterKernel kernel, int64_t chunkSamples)
+{
+    return kernel == OTT_FILTER_KERNEL_BLOCK && chunkSamples >= OTT_BIQUAD_BLOCK_MIN_SAMPLES;
+}
+
+void BuildLegacyCrossoverKernels(LegacyCrossoverKernels* kernels, const BiquadFilter* filters)
+{
+    for (int i = 0; i < 6; i++) {
+        BuildBiquadBlockKernel(&kernels->sections[i], &filters[i]);
+    }
+}
+
+/*
+ * The legacy crossover over a run of stereo input, as the engines' serial
+ * path computes it sample by sample: bands[0..5] get low, mid and high
+ * (left, right) before the processing gain. Simple mode cascades the low
+ * split and leaves the mid lines alone.
+ */
+void ProcessLegacyCrossoverBlock(BiquadFilter* filters, const LegacyCrossoverKernels* kernels, const float* left,
+                                 const float* right, int64_t numSamples, bool advanced, float* const bands[6])
+{
+    const BiquadBlockKernel* sections = kernels->sections;
+    RunBiquadFilterBlock(&filters[0], &sections[0], left, bands[0], NULL, numSamples);
+    RunBiquadFilterBlock(&filters[1], &sections[1], right, bands[1], NULL, numSamples);
+    if (advanced) {
+        RunBiquadFilterBlock(&filters[2], &sections[2], left, NULL, bands[2], numSamples);
+        RunBiquadFilterBlock(&filters[3], &sections[3], right, NULL, bands[3], numSamples);
+    } else {
+        RunBiquadFilterBlock(&filters[2], &sections[2], bands[0], bands[0], NULL, numSamples);
+        RunBiquadFilterBlock(&filters[3], &sections[3], bands[1], bands[1], NULL, numSamples);
+    }
+    RunBiquadFilterBlock(&filters[4], &sections[4], left, NULL, bands[4], numSamples);
+    RunBiquadFilterBlock(&filters[5], &sections[5], right, NULL, bands[5], numSamples);
+}
+
 // ============================================================================
 // FILTER OUTPUT FUNCTIONS
 // ============================================================================
@@ -67,17 +249,231 @@ float GetBiquadOutput(void* filterObj)
     return GetBiquadLowpass(filterObj);
 }
 
+// ============================================================================
+// SOA FILTER BANK LOAD/STORE
+// ============================================================================
+
+// Gather up to four filters into the lanes of a bank (called once per block)
+void LoadBiquadFilterBank(BiquadFilterBank* bank, const BiquadFilter* filters, const int lanes[4])
+{
+    float b1[4], a1[4], a2[4], b2[4], s1[4], s2[4];
+    
+    for (int lane = 0; lane < 4; lane++) {
+        if (lanes[lane] == OTT_BANK_UNUSED_LANE) {
+            b1[lane] = a1[lane] = a2[lane] = b2[lane] = 0.0f;
+            s1[lane] = s2[lane] = 0.0f;
+            continue;
+        }
+        
+        const BiquadFilter* filter = &filters[lanes[lane]];
+        b1[lane] = filter->b1;
+        a1[lane] = filter->coeff_a1;
+        a2[lane] = filter->coeff_a2;
+        b2[lane] = filter->coeff_b2;
+        s1[lane] = filter->state1;
+        s2[lane] = filter->state2;
+    }
+    
+    bank->b1 = Vec4Load(b1);
+    bank->coeff_a1 = Vec4Load(a1);
+    bank->coeff_a2 = Vec4Load(a2);
+    bank->coeff_b2 = Vec4Load(b2);
+    bank->state1 = Vec4Load(s1);
+    bank->state2 = Vec4Load(s2);
+}
+
+// Scatter bank state and the last sample's taps back into the filters
+void StoreBiquadFilterBank(const BiquadFilterBank* bank, const BiquadBankOutput* taps,
+                           BiquadFilter* filters, const int lanes[4])
+{
+    float s1[4], s2[4], input[4], processed[4], intermediate[4], output[4];
+    
+    Vec4Store(s1, bank->state1);
+    Vec4Store(s2, bank->state2);
+    Vec4Store(input, taps->input);
+    Vec4Store(processed, taps->processed_input);
+    Vec4Store(intermediate, taps->intermediate);
+    Vec4Store(output, taps->output);
+    
+    for (int lane = 0; lane < 4; lane++) {
+        if (lanes[lane] == OTT_BANK_UNUSED_LANE) continue;
+        
+        BiquadFilter* filter = &filters[lanes[lane]];
+        filter->state1 = s1[lane];
+        filter->state2 = s2[lane];
+        filter->input_store = input[lane];
+        filter->processed_input = processed[lane];
+        filter->intermediate = intermediate[lane];
+        filter->output = output[lane];
+    }
+}
+
+// ============================================================================
+// TPT STATE-VARIABLE FILTER (LR4 CROSSOVER)
+// ============================================================================
+
+// Coefficients for prewarped integrator gain g; state is kept per section,
+// so this is safe to call on a running network
+void SetSVFCoefficients(SVFCoefficients* point, float g)
+{
+    point->k = OTT_LR4_SECTION_DAMPING;
+    point->a1 = 1.0f / (1.0f + g * (g + point->k));
+    point->a2 = g * point->a1;
+    point->a3 = g * point->a2;
+}
+
+void CalculateSVFCoefficients(SVFCoefficients* point, float frequency, float sampleRate)
+{
+    SetSVFCoefficients(point, CrossoverPrewarp(frequency, sampleRate));
+}
+
+// Tunes numBands - 1 points to frequencies[] and clears the network
+void SetupLR4Crossover(SVFCoefficients* points, SVFStageState* stages, int numBands,
+                       const float* frequencies, float sampleRate)
+{
+    for (int point = 0; point < numBands - 1; point++) {
+        CalculateSVFCoefficients(&points[point], frequencies[point], sampleRate);
+    }
+    memset(stages, 0, OTT_LR4_STAGE_COUNT(numBands) * sizeof(SVFStageState));
+}
+
+// Retune a running network, as SetLR4CrossoverBankGains does per lane
+void SetLR4CrossoverGains(SVFCoefficients* points, int numBands, const float* gains)
+{
+    for (int point = 0; point < numBands - 1; point++) {
+        SetSVFCoefficients(&points[point], gains[point]);
+    }
+}
+
+// One sample's taps: input, bandpass (v1) and lowpass (v2)
+typedef struct {
+    float input;
+    float band;
+    float low;
+} SVFTaps;
+
+// The section in one lane of a stage. Same operation order as
+// ProcessSVFFilterBank, so the staged engine's crossover matches the fused
+// one bit for bit.
+static inline SVFTaps ProcessSVFSection(const SVFCoefficients* point, SVFStageState* stage, int lane, float input)
+{
+    float ic1eq = stage->ic1eq[lane];
+    float ic2eq = stage->ic2eq[lane];
+    
+    float v3 = input - ic2eq;
+    float v1 = point->a1 * ic1eq + point->a2 * v3;
+    float v2 = (ic2eq + point->a2 * ic1eq) + point->a3 * v3;
+    
+    stage->ic1eq[lane] = (v1 + v1) - ic1eq;
+    stage->ic2eq[lane] = (v2 + v2) - ic2eq;
+    
+    SVFTaps taps = { input, v1, v2 };
+    return taps;
+}
+
+static inline float GetSVFHighpass(const SVFCoefficients* point, const SVFTaps* taps)
+{
+    return (taps->input - point->k * taps->band) - taps->low;
+}
+
+static inline float GetSVFAllpass(const SVFCoefficients* point, const SVFTaps* taps)
+{
+    return taps->input - (point->k + point->k) * taps->band;
+}
+
+// Splits one stereo sample into bands[2b] / bands[2b + 1] = band b left /
+// right, walking the stages in lr4Stages order (see ott_plugin.h)
+void ProcessLR4Crossover(const SVFCoefficients* points, SVFStageState* stages, int numBands,
+                         float left, float right, float* bands)
+{
+    for (int channel = 0; channel < 2; channel++) {
+        SVFStageState* stage = stages;
+        float rest = channel ? right : left;
+        
+        for (int point = 0; point < numBands - 1; point++) {
+            const SVFCoefficients* c = &points[point];
+            
+            SVFTaps split = ProcessSVFSection(c, stage, channel, rest);
+            if (point & 1) {
+                float* band = &bands[2 * (point - 1) + channel];
+                SVFTaps allpass = ProcessSVFSection(c, stage, 2 + channel, *band);
+                *band = GetSVFAllpass(c, &allpass);
+            }
+            stage++;
+            
+            for (int pair = 0; pair < point / 2; pair++, stage++) {
+                float* lower = &bands[4 * pair + channel];
+                float* upper = &bands[4 * pair + 2 + channel];
+                SVFTaps lowerAllpass = ProcessSVFSection(c, stage, channel, *lower);
+                SVFTaps upperAllpass = ProcessSVFSection(c, stage, 2 + channel, *upper);
+                *lower = GetSVFAllpass(c, &lowerAllpass);
+                *upper = GetSVFAllpass(c, &upperAllpass);
+            }
+            
+            SVFTaps low = ProcessSVFSection(c, stage, channel, split.low);
+            SVFTaps high = ProcessSVFSection(c, stage, 2 + channel, GetSVFHighpass(c, &split));
+            stage++;
+            
+            bands[2 * point + channel] = low.low;
+            rest = GetSVFHighpass(c, &high);
+        }
+        
+        bands[2 * (numBands - 1) + channel] = rest;
+    }
+}
+
+// Coefficients of one bank stage; lanes 2-3 of a split stage at an even
+// point have no section and keep zero coefficients
+static void LoadLR4Stage(SVFFilterBank* stage, const SVFCoefficients* point, bool upperIdle)
+{
+    OTTVec4 k = Vec4Splat(point->k);
+    OTTVec4 a1 = Vec4Splat(point->a1);
+    OTTVec4 a2 = Vec4Splat(point->a2);
+    OTTVec4 a3 = Vec4Splat(point->a3);
+    
+    stage->k = upperIdle ? Vec4CombineLow(k, Vec4Zero()) : k;
+    stage->a1 = upperIdle ? Vec4CombineLow(a1, Vec4Zero()) : a1;
+    stage->a2 = upperIdle ? Vec4CombineLow(a2, Vec4Zero()) : a2;
+    stage->a3 = upperIdle ? Vec4CombineLow(a3, Vec4Zero()) : a3;
+}
+
+void LoadLR4CrossoverBank(LR4CrossoverBank* bank, const SVFCoefficients* points,
+                          const SVFStageState* stages, int numBands)
+{
+    SVFFilterBank* stage = bank->stage;
+    for (int point = 0; point < numBands - 1; point++) {
+        LoadLR4Stage(stage++, &points[point], !(point & 1));
+        for (int pair = 0; pair <= point / 2; pair++) {
+            LoadLR4Stage(stage++, &points[point], false);
+        }
+    }
+    
+    for (int index = 0; index < OTT_LR4_STAGE_COUNT(numBands); index++) {
+        bank->stage[index].ic1eq = Vec4Load(stages[index].ic1eq);
+        bank->stage[index].ic2eq = Vec4Load(stages[index].ic2eq);
+    }
+}
+
+void StoreLR4CrossoverBank(const LR4CrossoverBank* bank, SVFStageState* stages, int numBands)
+{
+    for (int index = 0; index < OTT_LR4_STAGE_COUNT(numBands); index++) {
+        Vec4Store(stages[index].ic1eq, bank->stage[index].ic1eq);
+        Vec4Store(stages[index].ic2eq, bank->stage[index].ic2eq);
+    }
+}
+
 // ============================================================================
 // FILTER COEFFICIENT CALCULATION (from sub_180126040)
 // ============================================================================
 
 void CalculateBiquadCoefficients(BiquadFilter* filter, float frequency, float sampleRate)
 {
-    // Calculate normalized frequency (0 to π)
-    double normalizedFreq = frequency * M_PI / sampleRate;
-    
     // Calculate intermediate values using bilinear transform
-    float tan_half_freq = tanf((float)normalizedFreq);
+    CalculateBiquadCoefficientsPrewarped(filter, CrossoverPrewarp(frequency, sampleRate));
+}
+
+void CalculateBiquadCoefficientsPrewarped(BiquadFilter* filter, float tan_half_freq)
+{
     float reciprocal = 1.0f / tan_half_freq;
     
     // Calculate denominator for coefficient normalization
@@ -128,62 +524,123 @@ void SetBiquadCoefficients(BiquadFilter* filter, float b0, float b1, float a1, f
 }
 
 // ============================================================================
-// CROSSOVER FILTER SETUP FOR OTT'S 3-BAND SYSTEM
+// CROSSOVER FILTER SETUP
 // ============================================================================
 
 void SetupOTTCrossoverFilters(OTTPlugin* plugin, float sampleRate)
 {
-    // OTT uses a 3-band crossover system:
-    // - Low/Mid split around 200 Hz
-    // - Mid/High split around 2 kHz
-    
-    float lowMidCrossover = 200.0f;   // Low to Mid crossover frequency
-    float midHighCrossover = 2000.0f; // Mid to High crossover frequency
-    
-    // Initialize all crossover filters
-    for (int i = 0; i < 6; i++) {
-        InitializeBiquadFilter(&plugin->crossoverFilters[i]);
+    // OTT uses a 3-band crossover system split at crossoverFrequencies
+    // (200 Hz and 2 kHz at the band controls' defaults). Every point is
+    // re-prewarped for the new rate and the smoothers jump to them. The
+    // coefficients come from the process-wide cache, so instances switching
+    // to a rate another one already set up skip the tanf and divisions.
+    const int points = (int)plugin->numBands - 1;
+    CrossoverCoefficients scratch[OTT_MAX_CROSSOVERS];
+    const CrossoverCoefficients* coefficients[OTT_MAX_CROSSOVERS];
+    for (int point = 0; point < points; point++) {
+        coefficients[point] = GetCrossoverCoefficients(plugin->crossoverFrequencies[point], sampleRate,
+                                                       &scratch[point]);
+        float g = coefficients[point]->g;
+        plugin->crossoverTargets[point] = g;
+        InitializeSmoother(&plugin->crossoverSmoothers[point], g, 0.0f);
+        SetSmootherLinearRamp(&plugin->crossoverSmoothers[point], OTT_CROSSOVER_RAMP_SAMPLES);
     }
     
-    // Setup crossover filter coefficients
     // Filters 0,1: Low/Mid split (Left/Right channels)
-    CalculateBiquadCoefficients(&plugin->crossoverFilters[0], lowMidCrossover, sampleRate);
-    CalculateBiquadCoefficients(&plugin->crossoverFilters[1], lowMidCrossover, sampleRate);
+    // Filters 2-5: Mid/High split
+    // All start from zero state
+    for (int i = 0; i < 6; i++) {
+        plugin->crossoverFilters[i] = coefficients[(i < 2) ? 0 : points - 1]->legacy;
+    }
     
-    // Filters 2,3: Process the highpass output from filters 0,1 for Mid/High split
-    CalculateBiquadCoefficients(&plugin->crossoverFilters[2], midHighCrossover, sampleRate);
-    CalculateBiquadCoefficients(&plugin->crossoverFilters[3], midHighCrossover, sampleRate);
+    // The LR4 network is kept ready at the same frequencies so the topology
+    // can be switched between blocks
+    ClearLR4Stages(plugin);
+    for (int point = 0; point < points; point++) {
+        plugin->lr4Points[point] = coefficients[point]->lr4;
+    }
     
-    // Filters 4,5: Additional processing stages
-    CalculateBiquadCoefficients(&plugin->crossoverFilters[4], midHighCrossover, sampleRate);
-    CalculateBiquadCoefficients(&plugin->crossoverFilters[5], midHighCrossover, sampleRate);
+    // The linear-phase network starts from silence too, on kernels for
+    // the new rate
+    if (plugin->linearPhase) ClearLinearPhaseCrossover(plugin->linearPhase);
+    RetuneLinearPhaseCrossover(plugin);
+}
+
+// Zero state for the LR4 network at every band count the arena holds
+void ClearLR4Stages(OTTPlugin* plugin)
+{
+    if (!plugin->lr4Stages) return;
+    memset(plugin->lr4Stages, 0, OTT_LR4_STAGE_COUNT((int)plugin->maxBands) * sizeof(SVFStageState));
+}
+
+// Brings the linear-phase kernels to the current points and rate while
+// that network is selected; the engines swap them in at block start. The
+// other networks are retuned when it is left (OTT_SetCrossoverTopology).
+void RetuneLinearPhaseCrossover(OTTPlugin* plugin)
+{
+    if (!plugin->linearPhase || plugin->crossoverTopology != OTT_CROSSOVER_LINEAR_PHASE) return;
+    DesignLinearPhaseKernels(plugin->linearPhase, (int)plugin->numBands, plugin->crossoverFrequencies,
+                             plugin->sampleRate);
+}
+
+// Retune the legacy filters without touching their state
+void SetLegacyCrossoverGains(BiquadFilter* filters, float lowMidGain, float midHighGain)
+{
+    for (int i = 0; i < 6; i++) {
+        CalculateBiquadCoefficientsPrewarped(&filters[i], (i < 2) ? lowMidGain : midHighGain);
+    }
 }
 
 // ============================================================================
-// HELPER FUNCTIONS FOR ANALYSIS
+// MODULATABLE CROSSOVER POINTS
 // ============================================================================
 
-// Calculate the magnitude response of a biquad filter at a given frequency
-float CalculateFilterResponse(BiquadFilter* filter, float frequency, float sampleRate)
+// Highest crossover point as a fraction of the sample rate; tan() runs
+// away near Nyquist
+#define CROSSOVER_MAX_NORMALIZED    0.45f
+
+// The mid/high point stays at least an octave above the low/mid one
+#define CROSSOVER_MIN_SPACING       2.0f
+
+// Bilinear prewarp, tan(pi * f / fs), shared by both topologies
+float CrossoverPrewarp(float frequency, float sampleRate)
 {
-    // Convert frequency to normalized frequency (0 to π)
-    float omega = 2.0f * M_PI * frequency / sampleRate;
-    
-    // Calculate complex response using filter coefficients
-    // This is useful for analyzing the crossover characteristics
-    float cos_omega = cosf(omega);
-    float cos_2omega = cosf(2.0f * omega);
-    
-    // Calculate numerator magnitude squared
-    float num_real = filter->b0 + filter->b1 * cos_omega;
-    float num_imag = -filter->b1 * sinf(omega);
-    float num_mag_sq = num_real * num_real + num_imag * num_imag;
-    
-    // Calculate denominator magnitude squared
-    float den_real = 1.0f + filter->coeff_a1 * cos_omega + filter->coeff_a2 * cos_2omega;
-    float den_imag = -filter->coeff_a1 * sinf(omega) - filter->coeff_a2 * sinf(2.0f * omega);
-    float den_mag_sq = den_real * den_real + den_imag * den_imag;
+    if (frequency > CROSSOVER_MAX_NORMALIZED * sampleRate) frequency = CROSSOVER_MAX_NORMALIZED * sampleRate;
+    double normalizedFreq = frequency * OTT_PI / sampleRate;
+    return tanf((float)normalizedFreq);
+}
+
+/*
+ * Control side of the crossover modulation: maps the band controls to
+ * crossover frequencies and their prewarped gains. All the tanf() work
+ * happens here, and so does any linear-phase kernel design; OTT_ProcessAudio
+ * only picks up crossoverTargets at block start and the engines glide the
+ * coefficients towards them per sample.
+ * The controls set the outer points; with more than three bands the inner
+ * ones are spread evenly in log frequency between them, and two bands
+ * split at their geometric mean.
+ */
+void UpdateCrossoverFrequencies(OTTPlugin* plugin)
+{
+    float shift = (plugin->bandControls[1] - 0.5f) * 2.0f * OTT_CROSSOVER_SHIFT_OCTAVES;
+    float lowMid = OTT_LOW_MID_CROSSOVER *
+                   exp2f((plugin->bandControls[0] - 0.5f) * 2.0f * OTT_CROSSOVER_EDGE_OCTAVES + shift);
+    float midHigh = OTT_MID_HIGH_CROSSOVER *
+                    exp2f((plugin->bandControls[2] - 0.5f) * 2.0f * OTT_CROSSOVER_EDGE_OCTAVES + shift);
+    if (midHigh < lowMid * CROSSOVER_MIN_SPACING) midHigh = lowMid * CROSSOVER_MIN_SPACING;
     
-    // Return magnitude response
-    return sqrtf(num_mag_sq / den_mag_sq);
+    const int points = (int)plugin->numBands - 1;
+    for (int point = 0; point < points; point++) {
+        float frequency;
+        if (points == 1) {
+            frequency = sqrtf(lowMid * midHigh);
+        } else if (point == points - 1) {
+            frequency = midHigh;
+        } else {
+            frequency = lowMid * powf(midHigh / lowMid, (float)point / (float)(points - 1));
+        }
+        plugin->crossoverFrequencies[point] = frequency;
+        plugin->crossoverTargets[point] = CrossoverPrewarp(frequency, plugin->sampleRate);
+    }
+    RetuneLinearPhaseCrossover(plugin);
 }
@@ -0,0 +1,182 @@
+/**
+ * OTT Gain Curve Tables
+ * Process-wide static gain curves per compressor parameter set (OTT_MATH_TABLE)
+ */
+
+#include "ott_plugin.h"
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+
+// ============================================================================
+// CURVE EVALUATION
+// ============================================================================
+
+// What a curve depends on. Only the main path's upward gain reads the
+// threshold itself, and only the main path reads upward_ratio, so the
+// alternative path keys on release_time alone.
+typedef struct {
+    uint64_t thresholdBits;
+    uint64_t releaseTimeBits;
+    uint64_t upwardRatioBits;
+    uint64_t mainPath;
+} GainCurveKey;
+
+typedef struct {
+    bool mainPath;
+    double threshold;
+    double releaseTime;
+    double upwardRatio;
+} GainCurveParameters;
+
+static inline uint64_t DoubleKeyBits(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void GetGainCurveParameters(const CompressorState* comp, GainCurveParameters* params, GainCurveKey* key)
+{
+    params->mainPath = comp->ratio_state <= NEGATIVE_THRESHOLD;
+    params->threshold = params->mainPath ? comp->threshold : 0.0;
+    params->releaseTime = comp->release_time;
+    params->upwardRatio = params->mainPath ? comp->upward_ratio : 0.0;
+    
+    key->thresholdBits = DoubleKeyBits(params->threshold);
+    key->releaseTimeBits = DoubleKeyBits(params->releaseTime);
+    key->upwardRatioBits = DoubleKeyBits(params->upwardRatio);
+    key->mainPath = params->mainPath;
+}
+
+// ProcessCompressorBand's gain and processed_envelope at x dB from the
+// threshold, in the branch that contains branchX. The below-threshold gain
+// is left unclamped (LookupGainCurve applies MIN_GAIN_THRESHOLD), floored
+// at FLT_MIN only to keep subnormals out of the table.
+static void EvaluateGainCurve(const GainCurveParameters* params, double x, double branchX,
+                              double* gain, double* envelope)
+{
+    const double tc = ENVELOPE_TIME_CONSTANT;
+    
+    *envelope = exp(x * tc);
+    
+    if (branchX <= 0.0) {
+        // Upward gain (main path) / expansion gain (alternative path)
+        double level = params->mainPath ? x + params->threshold : x;
+        *gain = fmax(exp((params->releaseTime - UNITY_GAIN) * level * tc), FLT_MIN);
+    } else if (params->mainPath) {
+        *gain = exp(fmin(*envelope * params->upwardRatio, MAX_COMPRESSION_RATIO) * tc);
+    } else if (branchX <= -NEGATIVE_THRESHOLD) {
+        *gain = *envelope;
+    } else {
+        *gain = MIN_GAIN_THRESHOLD;
+    }
+}
+
+// Cell width for the main path: a whole number of cells from the threshold
+// to the knee where upward_ratio * exp(x * tc) reaches MAX_COMPRESSION_RATIO,
+// so linear interpolation never cuts that corner either
+static double MainPathCellWidth(const GainCurveParameters* params)
+{
+    const double nominal = 1.0 / OTT_GAIN_CURVE_CELLS_PER_DB;
+    if (!(params->upwardRatio > 0.0)) return nominal;
+    
+    double knee = log(MAX_COMPRESSION_RATIO / params->upwardRatio) / ENVELOPE_TIME_CONSTANT;
+    double cells = round(knee / nominal);
+    return (cells >= 1.0) ? knee / cells : nominal;
+}
+
+// Cell ends are evaluated in the branch of the cell's interior, so a jump
+// on a cell edge shows up as two different edge values, not as a slope
+static void BuildGainCurve(GainCurve* curve, const GainCurveParameters* params)
+{
+    const double step = params->mainPath ? MainPathCellWidth(params) : 1.0 / OTT_GAIN_CURVE_CELLS_PER_DB;
+    const double edge = params->mainPath ? 0.0 : -NEGATIVE_THRESHOLD;
+    const double origin = edge - OTT_GAIN_CURVE_BELOW_DB * OTT_GAIN_CURVE_CELLS_PER_DB * step;
+    
+    curve->origin = (float)origin;
+    curve->cellsPerDb = (float)(1.0 / step);
+    curve->belowSlope = (float)((params->releaseTime - UNITY_GAIN) * ENVELOPE_TIME_CONSTANT);
+    
+    for (int cell = 0; cell < OTT_GAIN_CURVE_CELLS; cell++) {
+        double start = origin + cell * step;
+        double end = start + step;
+        double startGain, startEnvelope, endGain, endEnvelope;
+        EvaluateGainCurve(params, start, nextafter(start, end), &startGain, &startEnvelope);
+        EvaluateGainCurve(params, end, nextafter(end, start), &endGain, &endEnvelope);
+        
+        float* entry = curve->cells[cell];
+        entry[OTT_GAIN_CURVE_GAIN] = (float)startGain;
+        entry[OTT_GAIN_CURVE_GAIN_STEP] = (float)(endGain - startGain);
+        entry[OTT_GAIN_CURVE_ENVELOPE] = (float)startEnvelope;
+        entry[OTT_GAIN_CURVE_ENVELOPE_STEP] = (float)(endEnvelope - startEnvelope);
+    }
+}
+
+// ============================================================================
+// PROCESS-WIDE CACHE
+// ============================================================================
+
+/*
+ * Same scheme as the crossover coefficient cache: open-addressed and
+ * insert-only, slots claimed with a compare-exchange and published with a
+ * release store, immutable after that. Curves are 6 KB, so there are
+ * few slots; every band of a default instance shares one alternative-path
+ * curve. Without a free slot in the probe run the compressor gets no
+ * curve and computes its gains instead.
+ */
+#define GAIN_CURVE_CACHE_SLOTS      32
+#define GAIN_CURVE_CACHE_PROBES     8
+
+enum {
+    GAIN_CURVE_SLOT_EMPTY = 0,
+    GAIN_CURVE_SLOT_FILLING,
+    GAIN_CURVE_SLOT_READY
+};
+
+typedef struct {
+    _Atomic uint32_t state;
+    GainCurveKey key;
+    GainCurve curve;
+} GainCurveCacheSlot;
+
+static GainCurveCacheSlot GainCurveCache[GAIN_CURVE_CACHE_SLOTS];
+
+// The curve for comp's current parameters, built on first use; NULL when
+// the cache has no room for it
+const GainCurve* GetGainCurve(const CompressorState* comp)
+{
+    GainCurveParameters params;
+    GainCurveKey key;
+    GetGainCurveParameters(comp, &params, &key);
+    
+    uint64_t mixed = key.thresholdBits * 0x9e3779b97f4a7c15ull ^ key.releaseTimeBits * 0xc2b2ae3d27d4eb4full ^
+                     key.upwardRatioBits * 0x165667b19e3779f9ull ^ key.mainPath;
+    uint32_t hash = (uint32_t)(mixed ^ mixed >> 32);
+    hash ^= hash >> 15;
+    
+    for (uint32_t probe = 0; probe < GAIN_CURVE_CACHE_PROBES; probe++) {
+        GainCurveCacheSlot* slot = &GainCurveCache[(hash + probe) & (GAIN_CURVE_CACHE_SLOTS - 1)];
+        uint32_t state = atomic_load_explicit(&slot->state, memory_order_acquire);
+        
+        if (state == GAIN_CURVE_SLOT_EMPTY) {
+            uint32_t expected = GAIN_CURVE_SLOT_EMPTY;
+            if (atomic_compare_exchange_strong_explicit(&slot->state, &expected, GAIN_CURVE_SLOT_FILLING,
+                                                        memory_order_acquire, memory_order_acquire)) {
+                slot->key = key;
+                BuildGainCurve(&slot->curve, &params);
+                atomic_store_explicit(&slot->state, GAIN_CURVE_SLOT_READY, memory_order_release);
+                return &slot->curve;
+            }
+            state = expected;
+        }
+        
+        if (state == GAIN_CURVE_SLOT_FILLING) continue;
+        if (memcmp(&slot->key, &key, sizeof(key)) == 0) {
+            return &slot->curve;
+        }
+    }
+    
+    return NULL;
+}
@@ -0,0 +1,709 @@
+#ifndef OTT_KERNELS_H
+#define OTT_KERNELS_H
+
+/**
+ * OTT Inline Kernels
+ * Per-sample DSP building blocks that have to inline into the engine loops
+ * in ott_processing.c. Block-rate setup for these lives in the regular
+ * translation units.
+ */
+
+#include "ott_plugin.h"
+#include "ott_simd.h"
+#include <float.h>
+#include <string.h>
+
+// Engine bodies that are instantiated once per band count need the count
+// folded in as a constant, which only happens if they are inlined
+#if defined(__GNUC__)
+#define OTT_FORCE_INLINE inline __attribute__((always_inline))
+#else
+#define OTT_FORCE_INLINE inline
+#endif
+
+// ============================================================================
+// STRUCTURE-OF-ARRAYS BIQUAD FILTER BANK
+// ============================================================================
+
+/*
+ * Four BiquadFilters advanced together, one per vector lane. The bank is
+ * meant to live in registers for the duration of a block: load it from the
+ * plugin's BiquadFilter array, run the block, store it back. Unused lanes
+ * hold zero coefficients and produce silence.
+ */
+typedef struct {
+    OTTVec4 b1;                 // Highpass bandpass-tap coefficient
+    OTTVec4 coeff_a1;           // Coefficient a1
+    OTTVec4 coeff_a2;           // Coefficient a2
+    OTTVec4 coeff_b2;           // Coefficient b2
+    OTTVec4 state1;             // w[n-1]
+    OTTVec4 state2;             // w[n-2]
+} BiquadFilterBank;
+
+// Per-sample taps of a bank step (the lane form of input_store/intermediate/output)
+typedef struct {
+    OTTVec4 input;
+    OTTVec4 processed_input;
+    OTTVec4 intermediate;
+    OTTVec4 output;
+} BiquadBankOutput;
+
+#define OTT_BANK_UNUSED_LANE    (-1)
+
+void LoadBiquadFilterBank(BiquadFilterBank* bank, const BiquadFilter* filters, const int lanes[4]);
+void StoreBiquadFilterBank(const BiquadFilterBank* bank, const BiquadBankOutput* taps,
+                           BiquadFilter* filters, const int lanes[4]);
+
+// Lane-parallel ProcessBiquadFilter; same operation order, so each lane is
+// bit-identical to the scalar filter
+static inline BiquadBankOutput ProcessBiquadFilterBank(BiquadFilterBank* bank, OTTVec4 input)
+{
+    OTTVec4 w_n_minus_2 = bank->state2;
+    OTTVec4 w_n_minus_1 = bank->state1;
+
+    OTTVec4 temp1 = Vec4Mul(w_n_minus_1, bank->coeff_a1);
+    OTTVec4 processed_input = Vec4Sub(input, w_n_minus_2);
+    OTTVec4 temp2 = Vec4Mul(processed_input, bank->coeff_a2);
+    OTTVec4 feedback_term = Vec4Mul(processed_input, bank->coeff_b2);
+
+    OTTVec4 intermediate = Vec4Add(temp1, temp2);
+    OTTVec4 output = Vec4Add(Vec4Mul(w_n_minus_1, bank->coeff_a2), w_n_minus_2);
+    output = Vec4Add(output, feedback_term);
+
+    bank->state1 = Vec4Sub(Vec4Add(intermediate, intermediate), w_n_minus_1);
+    bank->state2 = Vec4Sub(Vec4Add(output, output), w_n_minus_2);
+
+    BiquadBankOutput taps = { input, processed_input, intermediate, output };
+    return taps;
+}
+
+static inline OTTVec4 GetBiquadBankLowpass(const BiquadBankOutput* taps)
+{
+    return taps->output;
+}
+
+static inline OTTVec4 GetBiquadBankHighpass(const BiquadFilterBank* bank, const BiquadBankOutput* taps)
+{
+    return Vec4Sub(Vec4Sub(taps->input, Vec4Mul(taps->intermediate, bank->b1)), taps->output);
+}
+
+// ============================================================================
+// BLOCK-PARALLEL LEGACY CROSSOVER
+// ============================================================================
+
+// One BiquadFilter unrolled four samples ahead (see BuildBiquadBlockKernel)
+typedef struct {
+    OTTVec4 intermediateState[2];   // Lane k: C_v A^k
+    OTTVec4 outputState[2];         // Lane k: C_lp A^k
+    OTTVec4 intermediateInput[4];   // Input j, lane k: C_v A^(k-1-j) B for j < k, D_v for j = k
+    OTTVec4 outputInput[4];         // ... and the same for lp
+    float stateState[2][2];         // A^4
+    float stateInput[2][4];         // Input j: A^(3-j) B
+} BiquadBlockKernel;
+
+/*
+ * The six legacy sections' look-ahead matrices. The sections only retune
+ * at block start, so the engines build these once per chunk and every
+ * span of the chunk reuses them.
+ */
+typedef struct {
+    BiquadBlockKernel sections[6];
+} LegacyCrossoverKernels;
+
+bool UseLegacyBlockKernel(OTTFilterKernel kernel, int64_t chunkSamples);
+void BuildLegacyCrossoverKernels(LegacyCrossoverKernels* kernels, const BiquadFilter* filters);
+void ProcessLegacyCrossoverBlock(BiquadFilter* filters, const LegacyCrossoverKernels* kernels, const float* left,
+                                 const float* right, int64_t numSamples, bool advanced, float* const bands[6]);
+
+// ============================================================================
+// LR4 CROSSOVER BANK
+// ============================================================================
+
+/*
+ * Four SVF sections advanced together, one per lane, with the same
+ * load/run/store life cycle as BiquadFilterBank.
+ */
+typedef struct {
+    OTTVec4 k;
+    OTTVec4 a1;
+    OTTVec4 a2;
+    OTTVec4 a3;
+    OTTVec4 ic1eq;
+    OTTVec4 ic2eq;
+} SVFFilterBank;
+
+typedef struct {
+    OTTVec4 input;
+    OTTVec4 band;               // v1
+    OTTVec4 low;                // v2
+} SVFBankOutput;
+
+static inline SVFBankOutput ProcessSVFFilterBank(SVFFilterBank* bank, OTTVec4 input)
+{
+    OTTVec4 v3 = Vec4Sub(input, bank->ic2eq);
+    OTTVec4 v1 = Vec4Add(Vec4Mul(bank->a1, bank->ic1eq), Vec4Mul(bank->a2, v3));
+    OTTVec4 v2 = Vec4Add(Vec4Add(bank->ic2eq, Vec4Mul(bank->a2, bank->ic1eq)), Vec4Mul(bank->a3, v3));
+    
+    bank->ic1eq = Vec4Sub(Vec4Add(v1, v1), bank->ic1eq);
+    bank->ic2eq = Vec4Sub(Vec4Add(v2, v2), bank->ic2eq);
+    
+    SVFBankOutput taps = { input, v1, v2 };
+    return taps;
+}
+
+static inline OTTVec4 GetSVFBankHighpass(const SVFFilterBank* bank, const SVFBankOutput* taps)
+{
+    return Vec4Sub(Vec4Sub(taps->input, Vec4Mul(bank->k, taps->band)), taps->low);
+}
+
+static inline OTTVec4 GetSVFBankAllpass(const SVFFilterBank* bank, const SVFBankOutput* taps)
+{
+    return Vec4Sub(taps->input, Vec4Mul(Vec4Add(bank->k, bank->k), taps->band));
+}
+
+/*
+ * The lr4Stages network as dependent bank steps per sample, one stage per
+ * step in the order laid out in ott_plugin.h. Three bands are seven
+ * sections per channel in four vector steps.
+ */
+typedef struct {
+    SVFFilterBank stage[OTT_LR4_MAX_STAGES];
+} LR4CrossoverBank;
+
+void LoadLR4CrossoverBank(LR4CrossoverBank* bank, const SVFCoefficients* points,
+                          const SVFStageState* stages, int numBands);
+void StoreLR4CrossoverBank(const LR4CrossoverBank* bank, SVFStageState* stages, int numBands);
+
+// Lane-parallel SetLR4CrossoverGains for every stage of the bank, gains[]
+// holding the numBands - 1 points' g
+static OTT_FORCE_INLINE void SetLR4CrossoverBankGains(LR4CrossoverBank* bank, const int numBands,
+                                                      const float* gains)
+{
+    SVFFilterBank* stage = bank->stage;
+    const OTTVec4 one = Vec4Splat(1.0f);
+    
+    for (int point = 0; point < numBands - 1; point++) {
+        OTTVec4 g = Vec4Splat(gains[point]);
+        OTTVec4 a1 = Vec4Div(one, Vec4Add(one, Vec4Mul(g, Vec4Add(g, Vec4Splat(OTT_LR4_SECTION_DAMPING)))));
+        OTTVec4 a2 = Vec4Mul(g, a1);
+        OTTVec4 a3 = Vec4Mul(g, a2);
+        
+        // The split stage idles in lanes 2-3 at even points
+        stage->a1 = (point & 1) ? a1 : Vec4CombineLow(a1, Vec4Zero());
+        stage->a2 = (point & 1) ? a2 : Vec4CombineLow(a2, Vec4Zero());
+        stage->a3 = (point & 1) ? a3 : Vec4CombineLow(a3, Vec4Zero());
+        stage++;
+        
+        for (int pair = 0; pair <= point / 2; pair++, stage++) {
+            stage->a1 = a1;
+            stage->a2 = a2;
+            stage->a3 = a3;
+        }
+    }
+}
+
+/*
+ * Lane-parallel ProcessLR4Crossover. bands[j] comes out as band 2j and
+ * 2j + 1, {L, R, L, R}; with an odd band count the last vector's lanes
+ * 2-3 are meaningless. The remainder above each point stays in lanes 2-3
+ * of the highpass it came out of until the next split picks it up.
+ */
+static OTT_FORCE_INLINE void ProcessLR4CrossoverBank(LR4CrossoverBank* bank, const int numBands,
+                                                     OTTVec4 stereoInput, OTTVec4 bands[OTT_MAX_BANDS / 2])
+{
+    SVFFilterBank* s = bank->stage;
+    OTTVec4 rest = stereoInput;
+    
+    for (int point = 0; point < numBands - 1; point++) {
+        // At odd points band point - 1 rides along for its allpass
+        OTTVec4 splitInput;
+        if (point == 0) {
+            splitInput = stereoInput;
+        } else if (point & 1) {
+            splitInput = Vec4CombineHighLow(rest, bands[point / 2]);
+        } else {
+            splitInput = Vec4CombineHigh(rest, rest);
+        }
+        SVFFilterBank* splitStage = s++;
+        SVFBankOutput split = ProcessSVFFilterBank(splitStage, splitInput);
+        
+        for (int pair = 0; pair < point / 2; pair++, s++) {
+            SVFBankOutput allpass = ProcessSVFFilterBank(s, bands[pair]);
+            bands[pair] = GetSVFBankAllpass(s, &allpass);
+        }
+        
+        SVFBankOutput lowHigh = ProcessSVFFilterBank(s, Vec4CombineLow(split.low, GetSVFBankHighpass(splitStage, &split)));
+        rest = GetSVFBankHighpass(s, &lowHigh);
+        s++;
+        
+        bands[point / 2] = (point & 1) ? Vec4CombineHighLow(GetSVFBankAllpass(splitStage, &split), lowHigh.low)
+                                       : lowHigh.low;
+    }
+    
+    const int top = numBands - 1;
+    bands[top / 2] = (top & 1) ? Vec4CombineLowHigh(bands[top / 2], rest) : Vec4CombineHigh(rest, rest);
+}
+
+// ============================================================================
+// PARAMETER SMOOTHERS
+// ============================================================================
+
+/*
+ * One sample of an OTTSmoother. A settled smoother returns its value
+ * without doing any arithmetic. An exponential smoother settles once a
+ * step no longer changes the float value: the step is a pure function of
+ * value, target and coeff, so every later step would return the same bits.
+ * A linear smoother settles when its ramp lands on the target.
+ */
+static inline float AdvanceSmoother(OTTSmoother* smoother)
+{
+    if (smoother->settled) return smoother->value;
+    
+    float next;
+    if (smoother->shape == OTT_SMOOTHER_LINEAR) {
+        next = (--smoother->rampRemaining > 0) ? smoother->value + smoother->step : smoother->target;
+        smoother->settled = smoother->rampRemaining <= 0;
+    } else {
+        next = (smoother->target - smoother->value) * smoother->coeff + smoother->value;
+        smoother->settled = next == smoother->value;
+    }
+    
+    if (smoother->selfTargeting) {
+        smoother->target = next;
+        smoother->settled = true;
+    }
+    
+    smoother->value = next;
+    return next;
+}
+
+// ============================================================================
+// FAST TRANSCENDENTALS (OTT_MATH_FAST)
+// ============================================================================
+
+/*
+ * Inline exp/log for the compressor's gain computer. Both use range
+ * reduction through the double exponent bits and a minimax polynomial
+ * evaluated in Estrin form to keep the dependency chain short.
+ *
+ * Measured over the full double range against glibc:
+ *   FastExp: max relative error 7.5e-8  (6.5e-7 dB of gain)
+ *   FastLog: max absolute error 7.1e-8  (6.2e-7 dB after LOG_SCALE_FACTOR)
+ *
+ * FastExp overflows to +inf for x > 709 and flushes to zero below -708
+ * instead of producing subnormals. FastLog defers to libm for zero,
+ * negative, subnormal, infinite and NaN arguments.
+ */
+
+#define OTT_LOG2E               1.44269504088896340736
+#define OTT_LN2                 0.69314718055994530942
+
+static inline double FastExp(double x)
+{
+    if (!(x > -708.0)) return (x != x) ? x : 0.0;
+    if (x > 709.0) return HUGE_VAL;
+    
+    // x * log2(e) = n + f with n integral and |f| <= 0.5
+    const double roundShifter = 6755399441055744.0;        // 1.5 * 2^52
+    double t = x * OTT_LOG2E;
+    double n = (t + roundShifter) - roundShifter;
+    double f = t - n;
+    
+    // 2^f on [-0.5, 0.5]
+    double f2 = f * f;
+    double p = (1.0000000716546822 + f * 0.693146967064733) +
+               f2 * ((0.24022119723848651 + f * 0.055507132735430752) +
+                     f2 * (0.009675541334209831 + f * 0.0013276471979286704));
+    
+    // 2^n straight into the exponent field
+    uint64_t bits = (uint64_t)((int64_t)n + 1023) << 52;
+    double scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+static inline double FastLog(double x)
+{
+    if (!(x >= DBL_MIN) || x == HUGE_VAL) return log(x);
+    
+    // Split x = m * 2^e with m in [sqrt(0.5), sqrt(2))
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int64_t e = (int64_t)(bits - 0x3fe6a09e667f3bcdull) >> 52;
+    bits -= (uint64_t)e << 52;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+    
+    // log(1 + t) = t * q(t)
+    double t = m - 1.0;
+    double t2 = t * t;
+    double t4 = t2 * t2;
+    double q = ((0.99999991785582898 + t * -0.50000344280959541) +
+                t2 * (0.33335607908950232 + t * -0.2497156028418962)) +
+               t4 * ((0.19884235275490855 + t * -0.17212425697234904) +
+                     t2 * (0.16338146972161199 + t * -0.10378718870652621));
+    
+    return (double)e * OTT_LN2 + t * q;
+}
+
+/*
+ * Single-precision versions for CompressorStateF: the same polynomials
+ * rounded to float, with the split done on the float exponent field.
+ *
+ * Measured over the full float range against double-precision libm:
+ *   FastExpF: max relative error 3.9e-6  (3.4e-5 dB of gain)
+ *   FastLogF: max absolute error 7.9e-6  (6.8e-5 dB after LOG_SCALE_FACTOR)
+ *
+ * That is within a few float ulps of expf()/logf() themselves. FastExpF
+ * flushes below -87 and overflows above 88.
+ */
+
+static inline float FastExpF(float x)
+{
+    if (!(x > -87.0f)) return (x != x) ? x : 0.0f;
+    if (x > 88.0f) return HUGE_VALF;
+    
+    const float roundShifter = 12582912.0f;                // 1.5 * 2^23
+    float t = x * (float)OTT_LOG2E;
+    float n = (t + roundShifter) - roundShifter;
+    float f = t - n;
+    
+    float f2 = f * f;
+    float p = (1.00000007f + f * 0.693146967f) +
+              f2 * ((0.240221197f + f * 0.0555071327f) +
+                    f2 * (0.00967554133f + f * 0.00132764720f));
+    
+    uint32_t bits = (uint32_t)((int32_t)n + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+static inline float FastLogF(float x)
+{
+    if (!(x >= FLT_MIN) || x == HUGE_VALF) return logf(x);
+    
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int32_t e = (int32_t)(bits - 0x3f3504f3u) >> 23;
+    bits -= (uint32_t)e << 23;
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    
+    float t = m - 1.0f;
+    float t2 = t * t;
+    float t4 = t2 * t2;
+    float q = ((0.999999918f + t * -0.500003443f) +
+               t2 * (0.333356079f + t * -0.249715603f)) +
+              t4 * ((0.198842353f + t * -0.172124257f) +
+                    t2 * (0.163381470f + t * -0.103787189f));
+    
+    return (float)e * (float)OTT_LN2 + t * q;
+}
+
+// Four FastExpF/FastLogF evaluations in one vector, bit-identical per lane
+#ifdef OTT_SIMD_SSE2
+
+static inline OTTVec4 Vec4FastExpF(OTTVec4 x)
+{
+    const OTTVec4 roundShifter = Vec4Splat(12582912.0f);
+    OTTVec4 t = Vec4Mul(x, Vec4Splat((float)OTT_LOG2E));
+    OTTVec4 n = Vec4Sub(Vec4Add(t, roundShifter), roundShifter);
+    OTTVec4 f = Vec4Sub(t, n);
+    
+    OTTVec4 f2 = Vec4Mul(f, f);
+    OTTVec4 p = Vec4Add(Vec4Add(Vec4Splat(1.00000007f), Vec4Mul(f, Vec4Splat(0.693146967f))),
+                Vec4Mul(f2, Vec4Add(Vec4Add(Vec4Splat(0.240221197f), Vec4Mul(f, Vec4Splat(0.0555071327f))),
+                        Vec4Mul(f2, Vec4Add(Vec4Splat(0.00967554133f), Vec4Mul(f, Vec4Splat(0.00132764720f)))))));
+    
+    __m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23);
+    OTTVec4 result = Vec4Mul(p, _mm_castsi128_ps(bits));
+    
+    // Out-of-range lanes computed garbage above; patch them like FastExpF
+    result = Vec4Select(Vec4CmpGt(x, Vec4Splat(88.0f)), Vec4Splat(HUGE_VALF), result);
+    OTTMask4 low = _mm_cmpngt_ps(x, Vec4Splat(-87.0f));
+    return Vec4Select(low, Vec4Select(Vec4CmpNaN(x), x, Vec4Zero()), result);
+}
+
+static inline OTTVec4 Vec4FastLogF(OTTVec4 x)
+{
+    __m128i bits = _mm_castps_si128(x);
+    __m128i e = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(0x3f3504f3)), 23);
+    OTTVec4 m = _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(e, 23)));
+    
+    OTTVec4 t = Vec4Sub(m, Vec4Splat(1.0f));
+    OTTVec4 t2 = Vec4Mul(t, t);
+    OTTVec4 t4 = Vec4Mul(t2, t2);
+    OTTVec4 q = Vec4Add(Vec4Add(Vec4Add(Vec4Splat(0.999999918f), Vec4Mul(t, Vec4Splat(-0.500003443f))),
+                                Vec4Mul(t2, Vec4Add(Vec4Splat(0.333356079f), Vec4Mul(t, Vec4Splat(-0.249715603f))))),
+                        Vec4Mul(t4, Vec4Add(Vec4Add(Vec4Splat(0.198842353f), Vec4Mul(t, Vec4Splat(-0.172124257f))),
+                                            Vec4Mul(t2, Vec4Add(Vec4Splat(0.163381470f), Vec4Mul(t, Vec4Splat(-0.103787189f)))))));
+    OTTVec4 result = Vec4Add(Vec4Mul(_mm_cvtepi32_ps(e), Vec4Splat((float)OTT_LN2)), Vec4Mul(t, q));
+    
+    // Zero, negative, subnormal, infinite and NaN lanes go to libm
+    OTTMask4 special = Mask4Or(_mm_cmpnge_ps(x, Vec4Splat(FLT_MIN)), Vec4CmpEq(x, Vec4Splat(HUGE_VALF)));
+    int specialBits = Mask4Bits(special);
+    if (specialBits) {
+        float in[4], out[4];
+        Vec4Store(in, x);
+        Vec4Store(out, result);
+        for (int i = 0; i < 4; i++) {
+            if (specialBits & (1 << i)) out[i] = logf(in[i]);
+        }
+        result = Vec4Load(out);
+    }
+    return result;
+}
+
+#else
+
+static inline OTTVec4 Vec4FastExpF(OTTVec4 x)
+{
+    for (int i = 0; i < 4; i++) x.v[i] = FastExpF(x.v[i]);
+    return x;
+}
+
+static inline OTTVec4 Vec4FastLogF(OTTVec4 x)
+{
+    for (int i = 0; i < 4; i++) x.v[i] = FastLogF(x.v[i]);
+    return x;
+}
+
+#endif
+
+// ============================================================================
+// GAIN CURVE LOOKUP (OTT_MATH_TABLE)
+// ============================================================================
+
+// Gain at x dB from the threshold, interpolated within its GainCurve cell
+// and clamped to MIN_GAIN_THRESHOLD; the same cell gives processed_envelope.
+// Below the grid (near silence) both are extrapolated from the bottom edge
+// with FastExpF. NaN reads as the bottom edge.
+static inline float LookupGainCurve(const GainCurve* curve, float x, float* envelope)
+{
+    float position = (x - curve->origin) * curve->cellsPerDb;
+    if (position < 0.0f) {
+        const float* edge = curve->cells[0];
+        float below = x - curve->origin;
+        *envelope = edge[OTT_GAIN_CURVE_ENVELOPE] * FastExpF(below * (float)ENVELOPE_TIME_CONSTANT);
+        return fmaxf(edge[OTT_GAIN_CURVE_GAIN] * FastExpF(below * curve->belowSlope), (float)MIN_GAIN_THRESHOLD);
+    }
+    position = fminf(fmaxf(position, 0.0f), (float)OTT_GAIN_CURVE_CELLS);
+    
+    int cell = (int)position;
+    if (cell > OTT_GAIN_CURVE_CELLS - 1) cell = OTT_GAIN_CURVE_CELLS - 1;
+    float fraction = position - (float)cell;
+    
+    const float* entry = curve->cells[cell];
+    *envelope = entry[OTT_GAIN_CURVE_ENVELOPE] + entry[OTT_GAIN_CURVE_ENVELOPE_STEP] * fraction;
+    float gain = entry[OTT_GAIN_CURVE_GAIN] + entry[OTT_GAIN_CURVE_GAIN_STEP] * fraction;
+    return fmaxf(gain, (float)MIN_GAIN_THRESHOLD);
+}
+
+// ============================================================================
+// BAND-PARALLEL COMPRESSOR BANK
+// ============================================================================
+
+/*
+ * Up to four CompressorStateF advanced together, one band per lane. Like
+ * BiquadFilterBank it is loaded for a block and stored back afterwards;
+ * the output of unused lanes is meaningless. All lanes share one math
+ * backend.
+ */
+typedef struct {
+    OTTVec4 rms_smoother;
+    OTTVec4 rms_smoothing_coeff;
+    OTTVec4 log_envelope;
+    OTTVec4 threshold;
+    OTTVec4 ratio_state;
+    OTTVec4 gain_reduction;
+    OTTVec4 attack_coeff;
+    OTTVec4 release_coeff;
+    OTTVec4 release_time;
+    OTTVec4 upward_ratio;
+    OTTVec4 envelope_output;
+    OTTVec4 processed_envelope;
+    OTTVec4 envelope_level;
+    OTTVec4 linear_coeff;
+    OTTVec4 knee_coeff;
+    bool fastMath;
+    bool gainTable;                 // OTT_MATH_TABLE and every lane has a curve
+    const GainCurve* gainCurves[4];
+    
+    // Lanes on the main (ratio_state <= NEGATIVE_THRESHOLD) path. ratio_state
+    // is a coefficient, so this is fixed for the block and whole branches
+    // can be skipped when no lane takes them.
+    OTTMask4 mainPath;
+    int mainLanes;
+} CompressorBank;
+
+// NULL entries in lanes[] are unused lanes
+void LoadCompressorBank(CompressorBank* bank, CompressorStateF* const lanes[4]);
+void StoreCompressorBank(const CompressorBank* bank, CompressorStateF* const lanes[4]);
+
+static inline OTTVec4 CompressorBankExp(OTTVec4 x, bool fastMath)
+{
+    if (fastMath) return Vec4FastExpF(x);
+    float v[4];
+    Vec4Store(v, x);
+    for (int i = 0; i < 4; i++) v[i] = expf(v[i]);
+    return Vec4Load(v);
+}
+
+static inline OTTVec4 CompressorBankLog(OTTVec4 x, bool fastMath)
+{
+    if (fastMath) return Vec4FastLogF(x);
+    float v[4];
+    Vec4Store(v, x);
+    for (int i = 0; i < 4; i++) v[i] = logf(v[i]);
+    return Vec4Load(v);
+}
+
+// LookupGainCurve per lane (the table has no vector gather)
+static inline OTTVec4 CompressorBankLookup(const CompressorBank* bank, OTTVec4 x, OTTVec4* envelope)
+{
+    float v[4], gain[4], env[4];
+    Vec4Store(v, x);
+    for (int i = 0; i < 4; i++) gain[i] = LookupGainCurve(bank->gainCurves[i], v[i], &env[i]);
+    *envelope = Vec4Load(env);
+    return Vec4Load(gain);
+}
+
+/*
+ * ProcessCompressorBandF for every lane at once. Each lane evaluates the
+ * same expressions in the same order as the scalar code, so the results
+ * are bit-identical; the ratio_state and threshold branches become lane
+ * masks instead. Transcendentals are shared across branches: the main
+ * path's log(envelope) and the alternative path's log(processed_input)
+ * are one vector log, and every branch needs at most two exps, which are
+ * likewise merged into two vector exps. With a gain table both exps give
+ * way to one curve lookup per lane.
+ */
+static OTT_FORCE_INLINE OTTVec4 ProcessCompressorBank(CompressorBank* bank, OTTVec4 inputPower, float outputLevel,
+                                                      OTTVec4 bandGain, float timeConstant)
+{
+    const bool fastMath = bank->fastMath;
+    const bool gainTable = bank->gainTable && timeConstant == (float)ENVELOPE_TIME_CONSTANT;
+    const OTTVec4 zero = Vec4Zero();
+    const OTTVec4 tc = Vec4Splat(timeConstant);
+    const OTTVec4 tiny = Vec4Splat(1e-30f);
+    const OTTVec4 logScale = Vec4Splat((float)LOG_SCALE_FACTOR);
+    const OTTVec4 minGain = Vec4Splat((float)MIN_GAIN_THRESHOLD);
+    const OTTVec4 unity = Vec4Splat((float)UNITY_GAIN);
+    
+    // RMS detection & smoothing
+    bank->rms_smoother = Vec4Add(Vec4Mul(Vec4Sub(bank->rms_smoother, inputPower), bank->rms_smoothing_coeff),
+                                 inputPower);
+    
+    OTTVec4 envelope_sqrt = Vec4Abs(Vec4Sqrt(bank->rms_smoother));
+    
+    const OTTMask4 mainPath = bank->mainPath;
+    const bool anyMain = bank->mainLanes != 0;
+    const bool anyAlt = bank->mainLanes != 0xf;
+    
+    // Alternative path: knee/linear level ahead of the shared log
+    OTTVec4 processed_input = zero;
+    OTTVec4 final_level = zero;
+    if (anyAlt) {
+        OTTVec4 envelope_exp;
+        if (fastMath && timeConstant == (float)ENVELOPE_TIME_CONSTANT) {
+            envelope_exp = bank->envelope_level;
+        } else {
+            envelope_exp = CompressorBankExp(Vec4Mul(bank->log_envelope, tc), fastMath);
+        }
+        
+        OTTVec4 linear_threshold = envelope_exp;
+        processed_input = Vec4Select(Vec4CmpLe(envelope_sqrt, linear_threshold),
+                                     Vec4Mul(bank->knee_coeff, linear_threshold),
+                                     Vec4Add(Vec4Mul(bank->linear_coeff, Vec4Sub(envelope_sqrt, linear_threshold)),
+                                             linear_threshold));
+        final_level = Vec4Select(Vec4CmpGe(processed_input, tiny), processed_input, tiny);
+    }
+    
+    OTTVec4 logLevel = Vec4Mul(CompressorBankLog(Vec4Select(mainPath, Vec4Add(envelope_sqrt, tiny),
+                                                            Vec4Add(processed_input, tiny)), fastMath),
+                               logScale);
+    OTTVec4 threshold = bank->threshold;
+    
+    // Main path: attack/release smoothing of the over-threshold amount
+    OTTVec4 compressed_level = zero;
+    if (anyMain) {
+        OTTVec4 max_reduction = Vec4Max(Vec4Sub(logLevel, threshold), zero);
+        OTTVec4 current_ratio = bank->gain_reduction;
+        OTTVec4 compression_coeff = Vec4Select(Vec4CmpLe(max_reduction, current_ratio),
+                                               bank->release_coeff, bank->attack_coeff);
+        compressed_level = Vec4Add(Vec4Mul(Vec4Sub(current_ratio, max_reduction), compression_coeff),
+                                   max_reduction);
+        bank->gain_reduction = Vec4Select(mainPath, compressed_level, current_ratio);
+    }
+    
+    // Alternative path: distance from threshold
+    OTTVec4 log_processed = logLevel;
+    OTTVec4 threshold_diff = Vec4Sub(log_processed, threshold);
+    OTTVec4 release_factor = Vec4Sub(bank->release_time, unity);
+    
+    OTTMask4 belowThreshold = Vec4CmpLe(compressed_level, threshold);
+    OTTMask4 mainBelow = Mask4And(mainPath, belowThreshold);
+    OTTMask4 mainAbove = Mask4AndNot(mainPath, belowThreshold);
+    OTTMask4 altBelow = Mask4AndNot(Vec4CmpLe(threshold_diff, zero), mainPath);
+    OTTMask4 needsSecond = Mask4Or(mainAbove, altBelow);
+    
+    OTTVec4 final_gain_reduction;
+    OTTVec4 first;
+    
+    if (gainTable) {
+        OTTVec4 curveX = Vec4Select(mainPath, Vec4Sub(compressed_level, threshold), threshold_diff);
+        final_gain_reduction = CompressorBankLookup(bank, curveX, &first);
+    } else {
+        // First exp: upward gain / downward multiplier / expansion gain
+        OTTVec4 firstArg = Vec4Select(mainPath,
+                                      Vec4Select(mainBelow,
+                                                 Vec4Mul(Vec4Mul(release_factor, compressed_level), tc),
+                                                 Vec4Mul(Vec4Sub(compressed_level, threshold), tc)),
+                                      Vec4Mul(threshold_diff, tc));
+        first = CompressorBankExp(firstArg, fastMath);
+        
+        // Second exp: downward ratio-limited gain / expansion release gain
+        OTTVec4 second = zero;
+        if (Mask4Bits(needsSecond)) {
+            OTTVec4 upward_factor = Vec4Mul(first, bank->upward_ratio);
+            OTTVec4 maxRatio = Vec4Splat((float)MAX_COMPRESSION_RATIO);
+            OTTVec4 limited = Vec4Select(Vec4CmpLe(upward_factor, maxRatio), upward_factor, maxRatio);
+            OTTVec4 secondArg = Vec4Select(mainPath, Vec4Mul(limited, tc),
+                                           Vec4Mul(Vec4Mul(release_factor, threshold_diff), tc));
+            second = CompressorBankExp(secondArg, fastMath);
+        }
+        
+        // Pick each lane's gain
+        OTTVec4 clampedFirst = Vec4Select(Vec4CmpLe(first, minGain), minGain, first);
+        OTTVec4 clampedSecond = Vec4Select(Vec4CmpLe(second, minGain), minGain, second);
+        OTTVec4 altAbove = Vec4Select(Vec4CmpLe(threshold_diff, Vec4Splat((float)-NEGATIVE_THRESHOLD)),
+                                      first, minGain);
+        final_gain_reduction = Vec4Select(mainPath,
+                                          Vec4Select(mainBelow, clampedFirst, second),
+                                          Vec4Select(altBelow, clampedSecond, altAbove));
+    }
+    
+    // State updates, each restricted to the lanes whose branch writes it
+    // (there first is exp(x * tc), which the curve's envelope column holds)
+    bank->processed_envelope = Vec4Select(needsSecond, first, bank->processed_envelope);
+    
+    if (anyAlt) {
+        // log(final_level) only differs from log(processed_input) where the
+        // level was floored
+        OTTVec4 log_final = log_processed;
+        OTTMask4 floored = Mask4AndNot(Vec4CmpEq(final_level, processed_input), mainPath);
+        if (Mask4Bits(floored)) {
+            OTTVec4 logFloor = Vec4Mul(CompressorBankLog(Vec4Add(final_level, tiny), fastMath), logScale);
+            log_final = Vec4Select(floored, logFloor, log_processed);
+        }
+        bank->log_envelope = Vec4Select(mainPath, bank->log_envelope, log_final);
+        bank->envelope_level = Vec4Select(mainPath, bank->envelope_level, Vec4Add(final_level, tiny));
+    }
+    
+    bank->envelope_output = final_gain_reduction;
+    
+    return Vec4Mul(Vec4Mul(final_gain_reduction, Vec4Splat(outputLevel)), bandGain);
+}
+
+#endif // OTT_KERNELS_H
@@ -1,12 +1,85 @@
 #include "ott_plugin.h"
+#include "ott_simd.h"
 #include <stdlib.h>
 #include <string.h>
 
+// ============================================================================
+// BAND COMPRESSOR SETUP
+// ============================================================================
+
+// OTT's low, mid and high band compressor settings
+typedef struct {
+    double threshold;
+    double ratio;
+    double attack;
+    double release;
+    double upwardRatio;
+    double attackMs;
+    double releaseMs;
+} BandCompressorSettings;
+
+static const BandCompressorSettings bandCompressorSettings[NUM_FREQUENCY_BANDS] = {
+    { -20.0, 2.0, 0.1,  0.01,  2.0, 10.0, 100.0 },
+    { -15.0, 3.0, 0.08, 0.015, 2.5,  8.0,  80.0 },
+    { -10.0, 4.0, 0.05, 0.02,  3.0,  5.0,  50.0 },
+};
+
+// Settings for band of numBands: three bands get OTT's own, any other count
+// interpolates them at the band's position between low and high
+static BandCompressorSettings GetBandCompressorSettings(int band, int numBands)
+{
+    double position = BandControlPosition(band, numBands);
+    int lower = (int)position;
+    if (lower >= NUM_FREQUENCY_BANDS - 1) return bandCompressorSettings[NUM_FREQUENCY_BANDS - 1];
+    
+    double t = position - lower;
+    if (t == 0.0) return bandCompressorSettings[lower];
+    
+    const BandCompressorSettings* a = &bandCompressorSettings[lower];
+    const BandCompressorSettings* b = &bandCompressorSettings[lower + 1];
+    BandCompressorSettings settings = {
+        a->threshold + (b->threshold - a->threshold) * t,
+        a->ratio + (b->ratio - a->ratio) * t,
+        a->attack + (b->attack - a->attack) * t,
+        a->release + (b->release - a->release) * t,
+        a->upwardRatio + (b->upwardRatio - a->upwardRatio) * t,
+        a->attackMs + (b->attackMs - a->attackMs) * t,
+        a->releaseMs + (b->releaseMs - a->releaseMs) * t,
+    };
+    return settings;
+}
+
+// Fresh compressors for the current band count, all on backend
+static void SetupBandCompressors(OTTPlugin* plugin, OTTMathBackend backend)
+{
+    SelectBandCompressors(plugin);
+    for (uint32_t band = 0; band < plugin->numBands; band++) {
+        BandCompressorSettings settings = GetBandCompressorSettings((int)band, (int)plugin->numBands);
+        plugin->compressors[band].mathBackend = backend;
+        InitializeCompressor(&plugin->compressors[band]);
+        SetCompressorParameters(&plugin->compressors[band], settings.threshold, settings.ratio,
+                                settings.attack, settings.release, settings.upwardRatio);
+    }
+}
+
 // ============================================================================
 // PLUGIN INITIALIZATION
 // ============================================================================
 
 void OTT_Initialize(OTTPlugin* plugin, float sampleRate)
+{
+    OTT_InitializeWithLimits(plugin, sampleRate, NULL);
+}
+
+void OTT_InitializeWithLimits(OTTPlugin* plugin, float sampleRate, const OTTInstanceLimits* limits)
+{
+    InitializePlugin(plugin, sampleRate, limits, NULL);
+}
+
+// Full setup. With arena == NULL the instance allocates its own arena;
+// otherwise it borrows a zeroed, cache-line aligned block of the size
+// ApplyInstanceLimits returns for the same limits (OTTInstancePool).
+void InitializePlugin(OTTPlugin* plugin, float sampleRate, const OTTInstanceLimits* limits, void* arena)
 {
     // Clear all memory to start with clean state
     memset(plugin, 0, sizeof(OTTPlugin));
@@ -17,11 +90,16 @@ void OTT_Initialize(OTTPlugin* plugin, float sampleRate)
     
     plugin->inputChannels = 2;
     plugin->outputChannels = 2;
-    plugin->inputChannelIndex = 0;
-    plugin->outputChannelIndex = 0;
+    plugin->inputChannelIndex = 1;
+    plugin->outputChannelIndex = 1;
     plugin->bypass = false;
     plugin->advancedMode = false;
     plugin->needsUpdate = true;
+    plugin->engineMode = OTT_ENGINE_FUSED;
+    plugin->compressorPrecision = OTT_DEFAULT_COMPRESSOR_PRECISION;
+    plugin->filterKernel = OTT_DEFAULT_FILTER_KERNEL;
+    plugin->crossoverTopology = OTT_DEFAULT_CROSSOVER_TOPOLOGY;
+    plugin->numBands = NUM_FREQUENCY_BANDS;
     
     // Initialize envelopes
     plugin->peakEnvelopeLeft = 0.0f;
@@ -31,72 +109,66 @@ void OTT_Initialize(OTTPlugin* plugin, float sampleRate)
     // ALLOCATE AUDIO BUFFERS
     // ========================================================================
     
-    // Allocate band processing buffers (6 bands for stereo 3-band processing)
-    plugin->bandBuffers = (float**)malloc(6 * sizeof(float*));
-    plugin->delayBuffers = (float**)malloc(8 * sizeof(float*)); // 6 bands + 2 original channels
-    
-    for (int band = 0; band < 6; band++) {
-        plugin->bandBuffers[band] = (float*)calloc(DELAY_BUFFER_SIZE, sizeof(float));
+    // Stereo band buffers and delay lines for up to maxBands bands, 2
+    // delay lines for the original channels and preset storage, all in
+    // one arena
+    plugin->arenaSize = ApplyInstanceLimits(plugin, sampleRate, limits);
+    if (arena) {
+        plugin->arena = arena;
+        plugin->arenaBorrowed = true;
+    } else {
+        plugin->arena = AllocateArena(plugin->arenaSize, limits && limits->hugePages, &plugin->arenaMapped);
     }
-    
-    for (int buffer = 0; buffer < 8; buffer++) {
-        plugin->delayBuffers[buffer] = (float*)calloc(DELAY_BUFFER_SIZE, sizeof(float));
+    if (plugin->arena) {
+        BindInstanceArena(plugin, plugin->arena);
+    } else {
+        // Only what lives in the struct itself is left: three bands on the
+        // legacy network
+        plugin->maxBands = NUM_FREQUENCY_BANDS;
+        plugin->crossoverTopology = OTT_CROSSOVER_LEGACY;
+    }
+    if (plugin->crossoverTopology == OTT_CROSSOVER_LINEAR_PHASE && !plugin->linearPhase) {
+        plugin->crossoverTopology = OTT_CROSSOVER_LR4;
     }
     
+    OTT_SetProcessingChunkSize(plugin, OTT_DEFAULT_CHUNK_SIZE);
+    
     // ========================================================================
     // INITIALIZE FILTER SYSTEM
     // ========================================================================
     
-    // Initialize all crossover filters
-    for (int i = 0; i < 6; i++) {
-        InitializeBiquadFilter(&plugin->crossoverFilters[i]);
-    }
-    
-    // Setup crossover frequencies for 3-band system
+    // Setup crossover frequencies for 3-band system; the band controls
+    // move them from here
+    plugin->sampleRate = sampleRate;
+    plugin->crossoverFrequencies[0] = OTT_LOW_MID_CROSSOVER;
+    plugin->crossoverFrequencies[1] = OTT_MID_HIGH_CROSSOVER;
     SetupOTTCrossoverFilters(plugin, sampleRate);
     
     // ========================================================================
     // INITIALIZE COMPRESSION SYSTEM
     // ========================================================================
     
-    InitializeCompressor(&plugin->compressorLow);
-    InitializeCompressor(&plugin->compressorMid);
-    InitializeCompressor(&plugin->compressorHigh);
-    
     // Setup compressor parameters for each band
-    SetCompressorParameters(&plugin->compressorLow, -20.0, 2.0, 0.1, 0.01, 2.0);
-    SetCompressorParameters(&plugin->compressorMid, -15.0, 3.0, 0.08, 0.015, 2.5);
-    SetCompressorParameters(&plugin->compressorHigh, -10.0, 4.0, 0.05, 0.02, 3.0);
+    SetupBandCompressors(plugin, OTT_DEFAULT_MATH_BACKEND);
     
     // ========================================================================
     // INITIALIZE PARAMETER SMOOTHERS
     // ========================================================================
     
-    // Allocate parameter smoothing filters (simple first-order lowpass)
-    plugin->depthSmoother = malloc(2 * sizeof(float));
-    plugin->upwardSmoother = malloc(2 * sizeof(float));
-    plugin->outputSmoother = malloc(2 * sizeof(float));
-    
-    // Initialize smoother states [current_value, smoothing_coefficient]
-    float* depthSmooth = (float*)plugin->depthSmoother;
-    depthSmooth[0] = 0.0f;   // Current value
-    depthSmooth[1] = 0.01f;  // Smoothing coefficient (1% per sample)
+    // Simple first-order lowpass smoothers
+    InitializeSmoother(&plugin->depthSmoother, 0.0f, 0.01f);      // 1% per sample
+    InitializeSmoother(&plugin->upwardSmoother, 0.0f, 0.01f);
+    InitializeSmoother(&plugin->outputSmoother, 1.0f, 0.005f);    // Start at unity gain, slower
     
-    float* upwardSmooth = (float*)plugin->upwardSmoother;
-    upwardSmooth[0] = 0.0f;
-    upwardSmooth[1] = 0.01f;
-    
-    float* outputSmooth = (float*)plugin->outputSmoother;
-    outputSmooth[0] = 1.0f;  // Start at unity gain
-    outputSmooth[1] = 0.005f; // Slower smoothing for output
+    // The output smoother chases finalGain and writes its value back into
+    // it, so each change of finalGain is a single step
+    plugin->outputSmoother.selfTargeting = true;
     
     // ========================================================================
     // PRESET SYSTEM SETUP
     // ========================================================================
     
-    plugin->currentPresetSlot = 0;
-    plugin->presetData = malloc(0x1000); // 4KB for preset storage
-    memset(plugin->presetData, 0, 0x1000);
+    plugin->currentPresetSlot = 0;      // presetData (4KB) is carved from the arena
     
     // ========================================================================
     // INITIALIZE PARAMETERS TO DEFAULTS
@@ -109,9 +181,9 @@ void OTT_Initialize(OTTPlugin* plugin, float sampleRate)
     plugin->timeControl = 0.3f;
     plugin->upwardRatio = 0.6f;  // Slight upward compression
     plugin->downwardRatio = 0.7f; // Moderate downward compression
-    plugin->lowBandGain = 0.5f;
-    plugin->midBandGain = 0.5f;
-    plugin->highBandGain = 0.5f;
+    for (int band = 0; band < OTT_MAX_BANDS; band++) {
+        plugin->bandOutputGains[band] = 0.5f;
+    }
     
     // ========================================================================
     // BUFFER MANAGEMENT SETUP
@@ -121,6 +193,9 @@ void OTT_Initialize(OTTPlugin* plugin, float sampleRate)
     plugin->bufferOffset = 0;
     plugin->writeIndex = 0;
     
+    // Zero latency until the host asks for lookahead
+    OTT_SetLookahead(plugin, 0.0f);
+    
     // Clear compressor state storage
     memset(plugin->compressorStates, 0, sizeof(plugin->compressorStates));
 }
@@ -133,29 +208,12 @@ void OTT_Cleanup(OTTPlugin* plugin)
 {
     if (!plugin) return;
     
-    // Free audio buffers
-    if (plugin->bandBuffers) {
-        for (int band = 0; band < 6; band++) {
-            free(plugin->bandBuffers[band]);
-        }
-        free(plugin->bandBuffers);
-    }
-    
-    if (plugin->delayBuffers) {
-        for (int buffer = 0; buffer < 8; buffer++) {
-            free(plugin->delayBuffers[buffer]);
-        }
-        free(plugin->delayBuffers);
+    // Audio buffers and preset data all live in the arena; a pool's
+    // instances give theirs back with the pool
+    if (!plugin->arenaBorrowed) {
+        FreeArena(plugin->arena, plugin->arenaSize, plugin->arenaMapped);
     }
     
-    // Free parameter smoothers
-    free(plugin->depthSmoother);
-    free(plugin->upwardSmoother);
-    free(plugin->outputSmoother);
-    
-    // Free preset data
-    free(plugin->presetData);
-    
     // Clear the plugin structure
     memset(plugin, 0, sizeof(OTTPlugin));
 }
@@ -176,25 +234,212 @@ void OTT_Process(OTTPlugin* plugin, float** inputs, float** outputs, int32_t sam
         return;
     }
     
-    // Process audio
+    // Arena allocation failed in OTT_Initialize
+    if (!plugin->arena) {
+        return;
+    }
+    
+    // Process audio with subnormals flushed in hardware; the previous
+    // mode is restored so the host thread is left as it was
+    OTTFloatEnv floatEnv = EnableFlushToZero();
     OTT_ProcessAudio(plugin, inputs, outputs, sampleCount);
+    RestoreFloatEnv(floatEnv);
 }
 
 // ============================================================================
 // VST INTEGRATION HELPERS
 // ============================================================================
 
-void OTT_SetSampleRate(OTTPlugin* plugin, float sampleRate)
+// False when the lookahead no longer fits the instance's delay ring at the
+// new rate (see OTT_SetLookahead)
+bool OTT_SetSampleRate(OTTPlugin* plugin, float sampleRate)
 {
+    plugin->sampleRate = sampleRate;
+    
     // Recalculate filter coefficients for new sample rate
     SetupOTTCrossoverFilters(plugin, sampleRate);
     
     // Update compressor timing for new sample rate
-    SetCompressorTiming(&plugin->compressorLow, 10.0f, 100.0f, sampleRate);
-    SetCompressorTiming(&plugin->compressorMid, 8.0f, 80.0f, sampleRate);
-    SetCompressorTiming(&plugin->compressorHigh, 5.0f, 50.0f, sampleRate);
+    for (uint32_t band = 0; band < plugin->numBands; band++) {
+        BandCompressorSettings settings = GetBandCompressorSettings((int)band, (int)plugin->numBands);
+        SetCompressorTiming(&plugin->compressors[band], settings.attackMs, settings.releaseMs, sampleRate);
+    }
+    
+    // Keep the lookahead fixed in time, not in samples
+    bool lookaheadFits = OTT_SetLookahead(plugin, plugin->lookaheadMs);
     
     plugin->needsUpdate = true;
+    return lookaheadFits;
+}
+
+void OTT_SetEngineMode(OTTPlugin* plugin, OTTEngineMode mode)
+{
+    // Both engines share filter, compressor and smoother state, so the
+    // switch can happen between any two blocks
+    plugin->engineMode = mode;
+}
+
+void OTT_SetMathBackend(OTTPlugin* plugin, OTTMathBackend backend)
+{
+    // OTT_MATH_TABLE looks up (or builds) each band's gain curve here, so
+    // the audio thread never does
+    for (uint32_t band = 0; band < plugin->numBands; band++) {
+        SetCompressorMathBackend(&plugin->compressors[band], backend);
+    }
+}
+
+void OTT_SetCompressorPrecision(OTTPlugin* plugin, OTTCompressorPrecision precision)
+{
+    // Single-precision state only lives for the duration of a block, so
+    // this can also change between any two blocks
+    plugin->compressorPrecision = precision;
+}
+
+void OTT_SetFilterKernel(OTTPlugin* plugin, OTTFilterKernel kernel)
+{
+    // All kernels run on the same filter state, so this can change
+    // between any two blocks too
+    plugin->filterKernel = kernel;
+}
+
+void OTT_SetCrossoverTopology(OTTPlugin* plugin, OTTCrossoverTopology topology)
+{
+    if (topology == plugin->crossoverTopology) return;
+    
+    // The legacy sections only split three bands, and the linear-phase
+    // split needs its buffers reserved through the instance limits
+    if (topology == OTT_CROSSOVER_LEGACY && plugin->numBands != NUM_FREQUENCY_BANDS) return;
+    if (topology == OTT_CROSSOVER_LINEAR_PHASE && !plugin->linearPhase) return;
+    if (topology == OTT_CROSSOVER_LR4 && !plugin->lr4Stages) return;
+    
+    // All networks stay configured; the one being left is cleared so an
+    // idle network always holds zero state and starts from silence when
+    // it is selected again. The one being entered is retuned to wherever
+    // the crossover smoothers are; linear-phase kernels are designed for
+    // the points here and swapped in at block start.
+    float gains[OTT_MAX_CROSSOVERS];
+    for (uint32_t point = 0; point + 1 < plugin->numBands; point++) {
+        gains[point] = plugin->crossoverSmoothers[point].value;
+    }
+    SetLegacyCrossoverGains(plugin->crossoverFilters, gains[0], gains[plugin->numBands - 2]);
+    SetLR4CrossoverGains(plugin->lr4Points, (int)plugin->numBands, gains);
+    
+    if (plugin->crossoverTopology == OTT_CROSSOVER_LR4) {
+        ClearLR4Stages(plugin);
+    } else if (plugin->crossoverTopology == OTT_CROSSOVER_LINEAR_PHASE) {
+        ClearLinearPhaseCrossover(plugin->linearPhase);
+    } else {
+        for (int i = 0; i < 6; i++) {
+            plugin->crossoverFilters[i].state1 = 0.0f;
+            plugin->crossoverFilters[i].state2 = 0.0f;
+        }
+    }
+    plugin->crossoverTopology = topology;
+    RetuneLinearPhaseCrossover(plugin);
+}
+
+void OTT_SetBandCount(OTTPlugin* plugin, int32_t numBands)
+{
+    if (numBands < OTT_MIN_BANDS) numBands = OTT_MIN_BANDS;
+    if (numBands > (int32_t)plugin->maxBands) numBands = (int32_t)plugin->maxBands;
+    if ((uint32_t)numBands == plugin->numBands) return;
+    
+    // Any count but three runs on LR4 unless it is linear-phase
+    if (numBands != NUM_FREQUENCY_BANDS && plugin->crossoverTopology == OTT_CROSSOVER_LEGACY) {
+        OTT_SetCrossoverTopology(plugin, OTT_CROSSOVER_LR4);
+    }
+    const OTTMathBackend backend = plugin->compressors[0].mathBackend;
+    plugin->numBands = (uint32_t)numBands;
+    
+    // The bands are new: crossover points, filter and compressor state and
+    // the delay ring start over as on a fresh instance, while the band
+    // controls and gains carry over to the new layout
+    UpdateCrossoverFrequencies(plugin);
+    SetupOTTCrossoverFilters(plugin, plugin->sampleRate);
+    SetupBandCompressors(plugin, backend);
+    UpdateBandOutputGains(plugin);
+    if (plugin->oversampler) ClearGainOversampler(plugin->oversampler);
+    memset(plugin->compressorStates, 0, sizeof(plugin->compressorStates));
+    
+    plugin->delayValidSamples = 0;
+    plugin->restSamples = 0;
+    plugin->sleeping = false;
+    plugin->needsUpdate = true;
+}
+
+void OTT_SetParameterRamp(OTTPlugin* plugin, int32_t rampSamples)
+{
+    // Linear ramps for depth and upward ratio; 0 restores the one-pole
+    SetSmootherLinearRamp(&plugin->depthSmoother, rampSamples);
+    SetSmootherLinearRamp(&plugin->upwardSmoother, rampSamples);
+}
+
+void OTT_SetProcessingChunkSize(OTTPlugin* plugin, int32_t chunkSize)
+{
+    // The staged engine stages a whole chunk in bandBuffers/delayBuffers
+    if (chunkSize < 1) chunkSize = 1;
+    if (chunkSize > (int32_t)plugin->maxBlockSize) chunkSize = (int32_t)plugin->maxBlockSize;
+    plugin->processingChunkSize = (uint32_t)chunkSize;
+}
+
+/*
+ * Returns false when lookaheadMs at the current rate is longer than the
+ * maxLatencySamples the instance was sized for (by default 50 ms at the
+ * creation rate, so raising the rate later can get here). The delay is
+ * then the longest the ring holds, and OTT_GetLatencySamples reports it;
+ * hosts that need the full lookahead at a higher rate have to create the
+ * instance with a larger OTTInstanceLimits.maxLatencySamples.
+ */
+bool OTT_SetLookahead(OTTPlugin* plugin, float lookaheadMs)
+{
+    if (!(lookaheadMs > 0.0f)) lookaheadMs = 0.0f;
+    if (lookaheadMs > OTT_MAX_LOOKAHEAD_MS) lookaheadMs = OTT_MAX_LOOKAHEAD_MS;
+    plugin->lookaheadMs = lookaheadMs;
+    
+    uint32_t lookaheadSamples = (uint32_t)(lookaheadMs * 0.001f * plugin->sampleRate + 0.5f);
+    bool fits = lookaheadSamples <= plugin->maxLatencySamples;
+    if (!fits) lookaheadSamples = plugin->maxLatencySamples;
+    if (lookaheadSamples == plugin->lookaheadSamples) return fits;
+    
+    // A new delay starts from silence rather than replaying stale bands;
+    // the ring reads as zeros until it has been written again
+    plugin->lookaheadSamples = lookaheadSamples;
+    plugin->delayValidSamples = 0;
+    plugin->restSamples = 0;
+    plugin->sleeping = false;
+    plugin->bufferIndex = 0;
+    plugin->writeIndex = 0;
+    return fits;
+}
+
+void OTT_SetOversampling(OTTPlugin* plugin, int32_t factor)
+{
+    // 1, 2, 4 or 8, rounded down to a power of two and clamped to what the
+    // instance limits reserved
+    if (!plugin->oversampler) return;
+    uint32_t stages = 0;
+    while (stages < plugin->oversampler->maxStages && (2 << stages) <= factor) stages++;
+    if (stages == plugin->oversampler->stages) return;
+    
+    // The new filters start from silence, like a new lookahead
+    SetGainOversampling(plugin->oversampler, stages);
+    plugin->restSamples = 0;
+    plugin->sleeping = false;
+}
+
+int32_t OTT_GetLatencySamples(const OTTPlugin* plugin)
+{
+    // Output latency is the lookahead plus the linear-phase crossover's
+    // delay when it is selected and the oversampled gain stage's, whatever
+    // the host block size
+    int32_t latency = (int32_t)plugin->lookaheadSamples;
+    if (plugin->crossoverTopology == OTT_CROSSOVER_LINEAR_PHASE) {
+        latency += OTT_LINEAR_PHASE_LATENCY;
+    }
+    if (plugin->oversampler && plugin->oversampler->stages) {
+        latency += (int32_t)plugin->oversampler->latency;
+    }
+    return latency;
 }
 
 void OTT_Reset(OTTPlugin* plugin)
@@ -203,28 +448,24 @@ void OTT_Reset(OTTPlugin* plugin)
     for (int i = 0; i < 6; i++) {
         InitializeBiquadFilter(&plugin->crossoverFilters[i]);
     }
+    ClearLR4Stages(plugin);
+    if (plugin->linearPhase) ClearLinearPhaseCrossover(plugin->linearPhase);
+    if (plugin->oversampler) ClearGainOversampler(plugin->oversampler);
     
     // Reset compressor states
-    InitializeCompressor(&plugin->compressorLow);
-    InitializeCompressor(&plugin->compressorMid);
-    InitializeCompressor(&plugin->compressorHigh);
+    for (uint32_t band = 0; band < plugin->numBands; band++) {
+        InitializeCompressor(&plugin->compressors[band]);
+    }
     
     // Clear envelopes
     plugin->peakEnvelopeLeft = 0.0f;
     plugin->peakEnvelopeRight = 0.0f;
     
-    // Clear buffers
-    if (plugin->bandBuffers) {
-        for (int band = 0; band < 6; band++) {
-            memset(plugin->bandBuffers[band], 0, DELAY_BUFFER_SIZE * sizeof(float));
-        }
-    }
-    
-    if (plugin->delayBuffers) {
-        for (int buffer = 0; buffer < 8; buffer++) {
-            memset(plugin->delayBuffers[buffer], 0, DELAY_BUFFER_SIZE * sizeof(float));
-        }
-    }
+    // Buffers are cleared lazily: bandBuffers are always written before
+    // they are read, and the delay ring reads as zeros up to the watermark
+    plugin->delayValidSamples = 0;
+    plugin->restSamples = 0;
+    plugin->sleeping = false;
     
     // Reset buffer positions
     plugin->bufferIndex = 0;
@@ -240,6 +481,7 @@ void OTT_Reset(OTTPlugin* plugin)
 void OTT_SavePreset(OTTPlugin* plugin, int presetSlot)
 {
     if (presetSlot < 0 || presetSlot >= 32) return; // Support up to 32 presets
+    if (!plugin->presetData) return;                // No arena, no preset area
     
     // Calculate preset storage location
     float* presetLocation = (float*)((char*)plugin->presetData + presetSlot * 0x6c + 0x138);
@@ -255,6 +497,7 @@ void OTT_SavePreset(OTTPlugin* plugin, int presetSlot)
 void OTT_LoadPreset(OTTPlugin* plugin, int presetSlot)
 {
     if (presetSlot < 0 || presetSlot >= 32) return;
+    if (!plugin->presetData) return;
     
     // Calculate preset storage location
     float* presetLocation = (float*)((char*)plugin->presetData + presetSlot * 0x6c + 0x138);
@@ -291,9 +534,9 @@ float OTT_GetCPUUsage(OTTPlugin* plugin)
     }
     
     // Additional cost based on active compressors
-    if (IsCompressorActive(&plugin->compressorLow)) usage += 2.0f;
-    if (IsCompressorActive(&plugin->compressorMid)) usage += 2.0f;
-    if (IsCompressorActive(&plugin->compressorHigh)) usage += 2.0f;
+    for (uint32_t band = 0; band < plugin->numBands; band++) {
+        if (IsCompressorActive(&plugin->compressors[band])) usage += 2.0f;
+    }
     
     return fminf(usage, 100.0f); // Cap at 100%
 }
@@ -306,9 +549,9 @@ float OTT_GetCPUUsage(OTTPlugin* plugin)
 // Example of how to integrate OTT into a VST host:
 
 int main() {
-    // Initialize plugin
-    OTTPlugin* ott = malloc(sizeof(OTTPlugin));
-    OTT_Initialize(ott, 44100.0f);
+    // Create the plugin (cache-line aligned; NULL limits take the defaults)
+    OTTPlugin* ott = OTT_CreatePlugin(44100.0f, NULL);
+    if (!ott) return 1;
     
     // Set some parameters
     OTT_SetParameter(ott, OTT_PARAM_DEPTH, 0.7f);        // 70% compression depth
@@ -339,8 +582,8 @@ int main() {
     free(inputR);
     free(outputL);
     free(outputR);
-    OTT_Cleanup(ott);
-    free(ott);
+    OTT_DestroyPlugin(ott);
     
     return 0;
 }
+*/
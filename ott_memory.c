@@ -0,0 +1,244 @@
+#include "ott_plugin.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+// ============================================================================
+// INSTANCE ARENA LAYOUT
+// ============================================================================
+
+// Transparent huge pages on x86-64/arm64 Linux
+#define OTT_HUGE_PAGE_SIZE      (2u * 1024u * 1024u)
+
+static inline size_t AlignArenaSize(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+// One line of buffer. Lines are padded by a cache line so equal power-of-
+// two lengths don't put the same index of every line in the same cache set.
+static inline size_t ArenaLineSize(uint32_t samples)
+{
+    return AlignArenaSize(samples * sizeof(float), OTT_CACHE_LINE_SIZE) + OTT_CACHE_LINE_SIZE;
+}
+
+/*
+ * Lays out the instance arena for the plugin's maxBlockSize, delayRingSize,
+ * maxBands and reservations and returns its size. With arena == NULL only
+ * the size is computed; otherwise the plugin's arena pointers are pointed
+ * into it. The size is a whole number of cache lines. Layout, in
+ * cache-line aligned segments (three bands: 6 and 8 lines):
+ *
+ *   bandBuffers[2 * maxBands] / delayBuffers[2 * maxBands + 2] pointer tables
+ *   2 * maxBands band lines of maxBlockSize samples
+ *   2 * maxBands + 2 delay lines of delayRingSize samples (bands, then input)
+ *   presetData
+ *   arenaCompressors, for more than three bands
+ *   lr4Stages
+ *   linear-phase crossover and its buffers, when reserved
+ *   oversampler and its rings, when reserved
+ *
+ * Binding clears the LR4 stages, prepares the linear-phase FFT plan and
+ * clears its state, and clears the oversampler and turns it off, so an
+ * instance copied from another one is ready once rebound.
+ */
+size_t BindInstanceArena(OTTPlugin* plugin, void* arena)
+{
+    const uint32_t bandLines = 2 * plugin->maxBands;
+    const uint32_t delayLines = bandLines + 2;
+    const size_t tableSize = AlignArenaSize((bandLines + delayLines) * sizeof(float*), OTT_CACHE_LINE_SIZE);
+    const size_t bandLine = ArenaLineSize(plugin->maxBlockSize);
+    const size_t delayLine = ArenaLineSize(plugin->delayRingSize);
+    const size_t compressorSize = (plugin->maxBands > NUM_FREQUENCY_BANDS) ?
+        AlignArenaSize(plugin->maxBands * sizeof(CompressorState), OTT_CACHE_LINE_SIZE) : 0;
+    const size_t lr4StageSize = OTT_LR4_STAGE_COUNT((int)plugin->maxBands) * sizeof(SVFStageState);
+    const size_t lr4Size = AlignArenaSize(lr4StageSize, OTT_CACHE_LINE_SIZE);
+    
+    // The optional blocks are sized through a header holding only the
+    // reservation; the header itself heads its block
+    LinearPhaseCrossover linearPhase = { .maxPoints = plugin->linearPhasePoints };
+    GainOversampler oversampler = { .maxStages = plugin->oversamplingStages };
+    const size_t linearPhaseHeader = AlignArenaSize(sizeof(LinearPhaseCrossover), OTT_CACHE_LINE_SIZE);
+    const size_t oversamplerHeader = AlignArenaSize(sizeof(GainOversampler), OTT_CACHE_LINE_SIZE);
+    const size_t linearPhaseSize = linearPhase.maxPoints ?
+        linearPhaseHeader + BindLinearPhaseCrossover(&linearPhase, NULL) : 0;
+    const size_t oversamplerSize = oversampler.maxStages ?
+        oversamplerHeader + BindGainOversampler(&oversampler, NULL) : 0;
+    
+    const size_t presetOffset = tableSize + bandLines * bandLine + delayLines * delayLine;
+    const size_t compressorOffset = presetOffset + OTT_PRESET_DATA_SIZE;
+    const size_t lr4Offset = compressorOffset + compressorSize;
+    const size_t linearPhaseOffset = lr4Offset + lr4Size;
+    const size_t oversamplerOffset = linearPhaseOffset + linearPhaseSize;
+    const size_t arenaSize = oversamplerOffset + oversamplerSize;
+    
+    if (!arena) return arenaSize;
+    
+    char* base = (char*)arena;
+    plugin->bandBuffers = (float**)base;
+    plugin->delayBuffers = plugin->bandBuffers + bandLines;
+    
+    char* line = base + tableSize;
+    for (uint32_t band = 0; band < bandLines; band++, line += bandLine) {
+        plugin->bandBuffers[band] = (float*)line;
+    }
+    for (uint32_t buffer = 0; buffer < delayLines; buffer++, line += delayLine) {
+        plugin->delayBuffers[buffer] = (float*)line;
+    }
+    
+    plugin->presetData = base + presetOffset;
+    plugin->arenaCompressors = compressorSize ? (CompressorState*)(base + compressorOffset) : NULL;
+    SelectBandCompressors(plugin);
+    
+    plugin->lr4Stages = (SVFStageState*)(base + lr4Offset);
+    memset(plugin->lr4Stages, 0, lr4StageSize);
+    
+    plugin->linearPhase = NULL;
+    if (linearPhaseSize) {
+        // The header stays in the arena, kernel banks and all, so binding
+        // the same arena again (a pool release) designs nothing
+        plugin->linearPhase = (LinearPhaseCrossover*)(base + linearPhaseOffset);
+        plugin->linearPhase->maxPoints = linearPhase.maxPoints;
+        BindLinearPhaseCrossover(plugin->linearPhase, base + linearPhaseOffset + linearPhaseHeader);
+        PrepareLinearPhaseCrossover(plugin->linearPhase);
+    }
+    plugin->oversampler = NULL;
+    if (oversamplerSize) {
+        plugin->oversampler = (GainOversampler*)(base + oversamplerOffset);
+        *plugin->oversampler = oversampler;
+        BindGainOversampler(plugin->oversampler, base + oversamplerOffset + oversamplerHeader);
+        ClearGainOversampler(plugin->oversampler);
+    }
+    return arenaSize;
+}
+
+// Points compressors at the set for numBands: the hot block's own up to
+// three bands, the arena's beyond that
+void SelectBandCompressors(OTTPlugin* plugin)
+{
+    plugin->compressors = (plugin->numBands > NUM_FREQUENCY_BANDS) ? plugin->arenaCompressors :
+                                                                     plugin->bandCompressors;
+}
+
+// Resolves limits (NULL: one default chunk, the longest lookahead at
+// sampleRate, OTT_MAX_BANDS, no linear-phase crossover and no oversampling)
+// into the plugin's block, latency, ring, band line, crossover point and
+// oversampling stage counts, and returns the arena size they need
+size_t ApplyInstanceLimits(OTTPlugin* plugin, float sampleRate, const OTTInstanceLimits* limits)
+{
+    int32_t maxBlockSize = OTT_DEFAULT_CHUNK_SIZE;
+    int32_t maxLatencySamples = (int32_t)ceilf(OTT_MAX_LOOKAHEAD_MS * 0.001f * sampleRate);
+    int32_t maxBands = OTT_MAX_BANDS;
+    int32_t maxOversampling = 1;
+    if (limits) {
+        maxBlockSize = limits->maxBlockSize;
+        maxLatencySamples = limits->maxLatencySamples;
+        maxBands = limits->maxBands;
+        maxOversampling = limits->maxOversampling;
+    }
+    if (maxBlockSize < 1) maxBlockSize = 1;
+    if (maxBlockSize > DELAY_BUFFER_SIZE) maxBlockSize = DELAY_BUFFER_SIZE;
+    if (maxLatencySamples < 0) maxLatencySamples = 0;
+    if (maxLatencySamples > DELAY_BUFFER_SIZE) maxLatencySamples = DELAY_BUFFER_SIZE;
+    if (maxBands < NUM_FREQUENCY_BANDS) maxBands = NUM_FREQUENCY_BANDS;
+    if (maxBands > OTT_MAX_BANDS) maxBands = OTT_MAX_BANDS;
+    
+    // The delay ring holds a chunk plus the lookahead
+    uint32_t ringSize = 1;
+    while (ringSize < (uint32_t)(maxBlockSize + maxLatencySamples)) ringSize <<= 1;
+    
+    plugin->maxBlockSize = (uint32_t)maxBlockSize;
+    plugin->maxLatencySamples = (uint32_t)maxLatencySamples;
+    plugin->delayRingSize = ringSize;
+    plugin->delayRingMask = ringSize - 1;
+    plugin->maxBands = (uint32_t)maxBands;
+    plugin->linearPhasePoints = (limits && limits->linearPhase) ? (uint32_t)maxBands - 1 : 0;
+    
+    // Factors round down to a power of two
+    uint32_t oversamplingStages = 0;
+    while (oversamplingStages < OTT_MAX_OVERSAMPLING_STAGES && (2 << oversamplingStages) <= maxOversampling) {
+        oversamplingStages++;
+    }
+    plugin->oversamplingStages = oversamplingStages;
+    
+    return BindInstanceArena(plugin, NULL);
+}
+
+// ============================================================================
+// ARENA ALLOCATION
+// ============================================================================
+
+// Zeroed, cache-line aligned memory. With hugePages on Linux an arena of at
+// least one huge page (a pool slab, or an 8-band linear-phase instance) is
+// mapped in whole huge pages and advised for THP. Smaller arenas would
+// more than double when rounded up, so they, any arena off Linux, and a
+// failed mapping come from aligned_alloc.
+void* AllocateArena(size_t size, bool hugePages, bool* mapped)
+{
+    *mapped = false;
+    
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (hugePages && size >= OTT_HUGE_PAGE_SIZE) {
+        size_t mapSize = AlignArenaSize(size, OTT_HUGE_PAGE_SIZE);
+        void* arena = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (arena != MAP_FAILED) {
+            madvise(arena, mapSize, MADV_HUGEPAGE);
+            *mapped = true;
+            return arena;           // Anonymous mappings are already zeroed
+        }
+    }
+#else
+    (void)hugePages;
+#endif
+    
+    size = AlignArenaSize(size, OTT_CACHE_LINE_SIZE);
+    void* arena = aligned_alloc(OTT_CACHE_LINE_SIZE, size);
+    if (arena) memset(arena, 0, size);
+    return arena;
+}
+
+void FreeArena(void* arena, size_t size, bool mapped)
+{
+    if (!arena) return;
+    
+#ifdef __linux__
+    if (mapped) {
+        munmap(arena, AlignArenaSize(size, OTT_HUGE_PAGE_SIZE));
+        return;
+    }
+#else
+    (void)size;
+    (void)mapped;
+#endif
+    
+    free(arena);
+}
+
+// ============================================================================
+// PLUGIN ALLOCATION
+// ============================================================================
+
+// Heap instance with the cache-line alignment OTTPlugin's hot block needs
+OTTPlugin* OTT_CreatePlugin(float sampleRate, const OTTInstanceLimits* limits)
+{
+    OTTPlugin* plugin = (OTTPlugin*)aligned_alloc(_Alignof(OTTPlugin), sizeof(OTTPlugin));
+    if (!plugin) return NULL;
+    
+    OTT_InitializeWithLimits(plugin, sampleRate, limits);
+    if (!plugin->arena) {
+        free(plugin);
+        return NULL;
+    }
+    return plugin;
+}
+
+void OTT_DestroyPlugin(OTTPlugin* plugin)
+{
+    if (!plugin) return;
+    
+    OTT_Cleanup(plugin);
+    free(plugin);
+}
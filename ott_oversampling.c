@@ -0,0 +1,345 @@
+/**
+ * OTT Oversampled Gain Stage
+ * Polyphase half-band interpolation and decimation around the band gains
+ */
+
+#include "ott_plugin.h"
+#include "ott_kernels.h"
+#include <string.h>
+
+#define OS_VECTORS      OTT_OVERSAMPLING_VECTORS
+#define OS_ROW          (4 * OS_VECTORS)            // Floats per interpolator ring slot
+#define OS_PAD_PAIRS    4                           // Pad ring length, a power of two
+
+// ============================================================================
+// HALF-BAND FILTERS
+// ============================================================================
+
+/*
+ * Kaiser-windowed half-band lowpasses of 4K + 3 taps. Every odd tap but the
+ * centre one (1/2) is zero, so only the K + 1 distinct even taps of one half
+ * are kept, outermost first and doubled for the interpolator's gain of two;
+ * they sum to 1/2. Stage 1, next to the base rate, is flat to 0.001 dB up to
+ * 0.4167 fs and down 80 dB from 0.5833 fs (20 / 28 kHz at 48 kHz), so what
+ * folds back off the product lands above 20 kHz. The stages above only
+ * have to clear images of a signal that is already oversampled, so they
+ * are much shorter.
+ */
+static const float HalfBandTaps1[16] = {
+    -4.803050173e-05f, 2.180724468e-04f, -5.871201235e-04f, 1.276212667e-03f,
+    -2.444151846e-03f, 4.291816861e-03f, -7.068828141e-03f, 1.108729331e-02f,
+    -1.675241976e-02f, 2.463116446e-02f, -3.560939809e-02f, 5.127536721e-02f,
+    -7.497875822e-02f, 1.154480812e-01f, -2.048850041e-01f, 6.341457027e-01f
+};
+
+// 23 taps, down 78 dB from 3/8 of its rate
+static const float HalfBandTaps2[6] = {
+    -1.353459812e-04f, 3.157454509e-03f, -1.671972962e-02f, 5.640386902e-02f,
+    -1.598501301e-01f, 6.171438822e-01f
+};
+
+// 15 taps, down 74 dB from 7/16 of its rate
+static const float HalfBandTaps3[4] = {
+    -5.393423843e-04f, 1.879553677e-02f, -1.138608729e-01f, 5.956046785e-01f
+};
+
+static const float* const HalfBandTaps[OTT_MAX_OVERSAMPLING_STAGES] = {
+    HalfBandTaps1, HalfBandTaps2, HalfBandTaps3
+};
+
+// K of each stage; its rings hold the 2K + 2 samples or pairs the taps span
+static const int HalfBandOrder[OTT_MAX_OVERSAMPLING_STAGES] = { 15, 5, 3 };
+
+static inline uint32_t HalfBandSpan(int stage)
+{
+    return 2 * (uint32_t)HalfBandOrder[stage] + 2;
+}
+
+// ============================================================================
+// BUFFER LAYOUT
+// ============================================================================
+
+static inline size_t AlignOversamplerSize(size_t size)
+{
+    return (size + OTT_CACHE_LINE_SIZE - 1) & ~(size_t)(OTT_CACHE_LINE_SIZE - 1);
+}
+
+// Carves count floats off the front of *cursor
+static float* TakeOversamplerBuffer(char** cursor, size_t* offset, size_t count)
+{
+    float* buffer = *cursor ? (float*)(*cursor + *offset) : NULL;
+    *offset += AlignOversamplerSize(count * sizeof(float));
+    return buffer;
+}
+
+/*
+ * Lays out the rings for oversampler->maxStages stages in memory and returns
+ * their size, a whole number of cache lines (none without stages). With
+ * memory == NULL only the size is computed.
+ */
+size_t BindGainOversampler(GainOversampler* oversampler, void* memory)
+{
+    const uint32_t maxStages = oversampler->maxStages;
+    if (!maxStages) return 0;
+    
+    char* cursor = (char*)memory;
+    size_t offset = 0;
+    float* upHistory[OTT_MAX_OVERSAMPLING_STAGES];
+    float* downHistory[OTT_MAX_OVERSAMPLING_STAGES];
+    for (uint32_t stage = 0; stage < maxStages; stage++) {
+        upHistory[stage] = TakeOversamplerBuffer(&cursor, &offset, 2 * HalfBandSpan(stage) * OS_ROW);
+        downHistory[stage] = TakeOversamplerBuffer(&cursor, &offset, 2 * HalfBandSpan(stage) * 4);
+    }
+    float* pad = TakeOversamplerBuffer(&cursor, &offset, OS_PAD_PAIRS * 4);
+    float* lastInput = TakeOversamplerBuffer(&cursor, &offset, OS_ROW);
+    
+    if (!memory) return offset;
+    
+    for (uint32_t stage = 0; stage < maxStages; stage++) {
+        oversampler->upHistory[stage] = upHistory[stage];
+        oversampler->downHistory[stage] = downHistory[stage];
+    }
+    oversampler->pad = pad;
+    oversampler->lastInput = lastInput;
+    return offset;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+
+// Silence in, silence out: every ring is zeroed and nothing counts as
+// repeated yet
+void ClearGainOversampler(GainOversampler* oversampler)
+{
+    if (!oversampler->maxStages) return;
+    
+    for (uint32_t stage = 0; stage < oversampler->maxStages; stage++) {
+        memset(oversampler->upHistory[stage], 0, 2 * HalfBandSpan(stage) * OS_ROW * sizeof(float));
+        memset(oversampler->downHistory[stage], 0, 2 * HalfBandSpan(stage) * 4 * sizeof(float));
+        oversampler->upIndex[stage] = 0;
+        oversampler->downIndex[stage] = 0;
+    }
+    memset(oversampler->pad, 0, OS_PAD_PAIRS * 4 * sizeof(float));
+    memset(oversampler->lastInput, 0, OS_ROW * sizeof(float));
+    oversampler->padIndex = 0;
+    oversampler->steadySamples = 0;
+}
+
+/*
+ * Selects 1 << stages oversampling (clamped to maxStages) and clears. Each
+ * stage delays by 2K + 1 samples of its high rate on the way up and again on
+ * the way down; the top-rate sum is padded by the rest of a base sample, so
+ * the whole stage is latency base samples late: 31 at 2x, 37 at 4x, 39 at
+ * 8x. A run of identical inputs leaves the state unchanged once it has
+ * passed every ring.
+ */
+void SetGainOversampling(GainOversampler* oversampler, uint32_t stages)
+{
+    if (stages > oversampler->maxStages) stages = oversampler->maxStages;
+    oversampler->stages = stages;
+    
+    uint32_t topDelay = 0, flush = OS_PAD_PAIRS;
+    for (uint32_t stage = 0; stage < stages; stage++) {
+        topDelay += (2 * (2 * (uint32_t)HalfBandOrder[stage] + 1)) << (stages - 1 - stage);
+        flush += 2 * ((HalfBandSpan(stage) + (1u << stage) - 1) >> stage);
+    }
+    const uint32_t pad = (0u - topDelay) & ((1u << stages) - 1);
+    oversampler->padPairs = pad / 2;
+    oversampler->latency = (topDelay + pad) >> stages;
+    oversampler->flushSamples = flush;
+    
+    ClearGainOversampler(oversampler);
+}
+
+// ============================================================================
+// PROCESSING
+// ============================================================================
+
+// Two bands per vector, gains scaled by the output level; a missing upper
+// band has zero samples and gain. Returns the vector count, bands first.
+static int GatherOversamplerInput(int numBands, const float* bands, const float* gains, float outputLevel,
+                                  OTTVec4* input)
+{
+    const int pairs = (numBands + 1) / 2;
+    for (int pair = 0; pair < pairs; pair++) {
+        const int lower = 2 * pair, upper = 2 * pair + 1;
+        const float lowerGain = gains[lower] * outputLevel;
+        if (upper < numBands) {
+            const float upperGain = gains[upper] * outputLevel;
+            input[pair] = Vec4Set(bands[2 * lower], bands[2 * lower + 1], bands[2 * upper], bands[2 * upper + 1]);
+            input[pairs + pair] = Vec4Set(lowerGain, lowerGain, upperGain, upperGain);
+        } else {
+            input[pair] = Vec4Set(bands[2 * lower], bands[2 * lower + 1], 0.0f, 0.0f);
+            input[pairs + pair] = Vec4Set(lowerGain, lowerGain, 0.0f, 0.0f);
+        }
+    }
+    return 2 * pairs;
+}
+
+/*
+ * One sample of vectors in, two out at twice the rate:
+ *   y[2n]     = sum_q c_q (x[n - q] + x[n - 2K - 1 + q])
+ *   y[2n + 1] = x[n - K]
+ * The ring keeps the last 2K + 2 inputs twice over, so the taps read one
+ * contiguous window: after a write at slot i, x[n - m] is at i + 2K + 2 - m.
+ */
+static void InterpolateHalfBand(GainOversampler* oversampler, int stage, const OTTVec4* x, OTTVec4* y,
+                                int vectors)
+{
+    const int order = HalfBandOrder[stage];
+    const float* taps = HalfBandTaps[stage];
+    const uint32_t span = HalfBandSpan(stage);
+    const uint32_t index = oversampler->upIndex[stage];
+    float* window = oversampler->upHistory[stage] + (size_t)index * OS_ROW;
+    
+    for (int v = 0; v < vectors; v++) {
+        Vec4Store(window + 4 * v, x[v]);
+        Vec4Store(window + (size_t)span * OS_ROW + 4 * v, x[v]);
+    }
+    
+    // Vectors come in band / gain pairs of two and every stage has an even
+    // number of taps, so four independent sums cover two vectors
+    const float* newest = window + (size_t)span * OS_ROW;
+    const float* oldest = window + OS_ROW;
+    for (int v = 0; v < vectors; v += 2) {
+        OTTVec4 acc0 = Vec4Zero(), acc1 = Vec4Zero(), acc2 = Vec4Zero(), acc3 = Vec4Zero();
+        for (int q = 0; q <= order; q += 2) {
+            const float* late = newest - q * OS_ROW + 4 * v;
+            const float* early = oldest + q * OS_ROW + 4 * v;
+            OTTVec4 tap = Vec4Splat(taps[q]), nextTap = Vec4Splat(taps[q + 1]);
+            acc0 = Vec4Add(acc0, Vec4Mul(tap, Vec4Add(Vec4Load(late), Vec4Load(early))));
+            acc1 = Vec4Add(acc1, Vec4Mul(tap, Vec4Add(Vec4Load(late + 4), Vec4Load(early + 4))));
+            acc2 = Vec4Add(acc2, Vec4Mul(nextTap, Vec4Add(Vec4Load(late - OS_ROW), Vec4Load(early + OS_ROW))));
+            acc3 = Vec4Add(acc3, Vec4Mul(nextTap, Vec4Add(Vec4Load(late - OS_ROW + 4), Vec4Load(early + OS_ROW + 4))));
+        }
+        y[v] = Vec4Add(acc0, acc2);
+        y[v + 1] = Vec4Add(acc1, acc3);
+        y[vectors + v] = Vec4Load(newest - order * OS_ROW + 4 * v);
+        y[vectors + v + 1] = Vec4Load(newest - order * OS_ROW + 4 * v + 4);
+    }
+    oversampler->upIndex[stage] = (index + 1 == span) ? 0 : index + 1;
+}
+
+/*
+ * One pair (v[2n], v[2n + 1]) in, lanes (v[2n], v[2n + 1]) of both channels,
+ * one sample out at half the rate in lanes 0-1:
+ *   y[n] = (v[2n - 2K - 1] + sum_q c_q (v[2n - 2q] + v[2n - 4K - 2 + 2q])) / 2
+ * The even taps run on whole pairs and the odd halves are dropped.
+ */
+static OTTVec4 DecimateHalfBand(GainOversampler* oversampler, int stage, OTTVec4 pair)
+{
+    const int order = HalfBandOrder[stage];
+    const float* taps = HalfBandTaps[stage];
+    const uint32_t span = HalfBandSpan(stage);
+    const uint32_t index = oversampler->downIndex[stage];
+    float* window = oversampler->downHistory[stage] + 4 * index;
+    
+    Vec4Store(window, pair);
+    Vec4Store(window + 4 * span, pair);
+    
+    const float* newest = window + 4 * span;
+    const float* oldest = window + 4;
+    OTTVec4 acc0 = Vec4Zero(), acc1 = Vec4Zero();
+    for (int q = 0; q <= order; q += 2) {
+        acc0 = Vec4Add(acc0, Vec4Mul(Vec4Splat(taps[q]), Vec4Add(Vec4Load(newest - 4 * q), Vec4Load(oldest + 4 * q))));
+        acc1 = Vec4Add(acc1, Vec4Mul(Vec4Splat(taps[q + 1]),
+                                     Vec4Add(Vec4Load(newest - 4 * q - 4), Vec4Load(oldest + 4 * q + 4))));
+    }
+    OTTVec4 acc = Vec4Add(acc0, acc1);
+    OTTVec4 centre = Vec4Load(newest - 4 * (order + 1));
+    oversampler->downIndex[stage] = (index + 1 == span) ? 0 : index + 1;
+    return Vec4Mul(Vec4Splat(0.5f), Vec4Add(acc, Vec4CombineHigh(centre, centre)));
+}
+
+/*
+ * One base-rate sample of the gain stage: band b is bands[2b] / bands[2b + 1],
+ * scaled by gains[b] * outputLevel and summed into left / right,
+ * oversampler->latency samples late.
+ */
+void ProcessOversampledGain(GainOversampler* oversampler, int numBands, const float* bands, const float* gains,
+                            float outputLevel, float* left, float* right)
+{
+    const int stages = (int)oversampler->stages;
+    OTTVec4 input[OS_VECTORS];
+    const int vectors = GatherOversamplerInput(numBands, bands, gains, outputLevel, input);
+    const int pairs = vectors / 2;
+    
+    if (memcmp(input, oversampler->lastInput, vectors * sizeof(OTTVec4)) != 0) {
+        memcpy(oversampler->lastInput, input, vectors * sizeof(OTTVec4));
+        oversampler->steadySamples = 0;
+    } else if (oversampler->steadySamples < oversampler->flushSamples) {
+        oversampler->steadySamples++;
+    }
+    
+    // Up: stage s turns 1 << s samples into 2 << s, each vectors wide
+    OTTVec4 buffers[2][OTT_MAX_OVERSAMPLING * OS_VECTORS];
+    const OTTVec4* samples = input;
+    for (int stage = 0; stage < stages; stage++) {
+        OTTVec4* next = buffers[stage & 1];
+        for (int sample = 0; sample < (1 << stage); sample++) {
+            InterpolateHalfBand(oversampler, stage, samples + sample * vectors, next + 2 * sample * vectors,
+                                vectors);
+        }
+        samples = next;
+    }
+    
+    // Gain and band sum at the top rate, two samples per pair vector, then
+    // the pad delay
+    OTTVec4 stereo[OTT_MAX_OVERSAMPLING / 2];
+    for (int pair = 0; pair < (1 << stages) / 2; pair++) {
+        const OTTVec4* even = samples + 2 * pair * vectors;
+        const OTTVec4* odd = even + vectors;
+        OTTVec4 evenSum = Vec4Mul(even[0], even[pairs]);
+        OTTVec4 oddSum = Vec4Mul(odd[0], odd[pairs]);
+        for (int v = 1; v < pairs; v++) {
+            evenSum = Vec4Add(evenSum, Vec4Mul(even[v], even[pairs + v]));
+            oddSum = Vec4Add(oddSum, Vec4Mul(odd[v], odd[pairs + v]));
+        }
+        OTTVec4 sum = Vec4Add(Vec4CombineLow(evenSum, oddSum), Vec4CombineHigh(evenSum, oddSum));
+        
+        const uint32_t padIndex = oversampler->padIndex;
+        Vec4Store(oversampler->pad + 4 * padIndex, sum);
+        stereo[pair] = Vec4Load(oversampler->pad + 4 * ((padIndex - oversampler->padPairs) & (OS_PAD_PAIRS - 1)));
+        oversampler->padIndex = (padIndex + 1) & (OS_PAD_PAIRS - 1);
+    }
+    
+    // Down: stage s turns 1 << s pairs into as many samples, paired up
+    // again for the stage below
+    OTTVec4 sample = Vec4Zero();
+    for (int stage = stages - 1; stage >= 0; stage--) {
+        for (int pair = 0; pair < (1 << stage); pair++) {
+            sample = DecimateHalfBand(oversampler, stage, stereo[pair]);
+            if (pair & 1) {
+                stereo[pair / 2] = Vec4CombineLow(stereo[pair / 2], sample);
+            } else {
+                stereo[pair / 2] = sample;
+            }
+        }
+    }
+    
+    float lanes[4];
+    Vec4Store(lanes, sample);
+    *left = lanes[0];
+    *right = lanes[1];
+}
+
+// True when one more sample of silent bands with these gains would leave
+// the state as it is: the same input has repeated through every ring
+bool GainOversamplerAtRest(const GainOversampler* oversampler, int numBands, const float* gains,
+                           float outputLevel)
+{
+    if (!oversampler->stages) return true;
+    if (oversampler->steadySamples < oversampler->flushSamples) return false;
+    
+    const float silentBands[2 * OTT_MAX_BANDS] = { 0.0f };
+    OTTVec4 input[OS_VECTORS];
+    const int vectors = GatherOversamplerInput(numBands, silentBands, gains, outputLevel, input);
+    const int pairs = vectors / 2;
+    
+    // Bands compare as zero of either sign; gains have to match exactly
+    for (int v = 0; v < pairs; v++) {
+        if (Mask4Bits(Vec4CmpEq(Vec4Load(oversampler->lastInput + 4 * v), Vec4Zero())) != 0xf) return false;
+    }
+    return memcmp(input + pairs, oversampler->lastInput + 4 * pairs, pairs * sizeof(OTTVec4)) == 0;
+}
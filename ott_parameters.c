@@ -1,4 +1,5 @@
 #include "ott_plugin.h"
+#include <stdio.h>
 
 // ============================================================================
 // PARAMETER INFORMATION DATABASE
@@ -91,6 +92,34 @@ float ConvertRatioToVSTValue(float internalRatio)
     }
 }
 
+// ============================================================================
+// BAND LAYOUT MAPPING
+// ============================================================================
+
+// Where band sits on the low/mid/high controls: 0 is Low, 1 Mid, 2 High.
+// Three bands land on the controls exactly; other counts spread evenly
+// between Low and High.
+double BandControlPosition(int band, int numBands)
+{
+    return (double)band * (NUM_FREQUENCY_BANDS - 1) / (numBands - 1);
+}
+
+void UpdateBandOutputGains(OTTPlugin* plugin)
+{
+    for (uint32_t band = 0; band < plugin->numBands; band++) {
+        double position = BandControlPosition((int)band, (int)plugin->numBands);
+        int lower = (int)position;
+        if (lower >= NUM_FREQUENCY_BANDS - 1) {
+            plugin->bandOutputGains[band] = plugin->bandGains[NUM_FREQUENCY_BANDS - 1];
+            continue;
+        }
+        
+        float t = (float)(position - lower);
+        plugin->bandOutputGains[band] = (t == 0.0f) ? plugin->bandGains[lower] :
+            plugin->bandGains[lower] + (plugin->bandGains[lower + 1] - plugin->bandGains[lower]) * t;
+    }
+}
+
 // ============================================================================
 // MAIN PARAMETER SETTING FUNCTION
 // ============================================================================
@@ -105,9 +134,12 @@ void OTT_SetParameter(OTTPlugin* plugin, int32_t parameterIndex, float value)
     // Clamp value to valid range
     value = fmaxf(0.0f, fminf(1.0f, value));
     
-    // Calculate preset storage location (for automation/preset saving)
+    // Calculate preset storage location (for automation/preset saving).
+    // Without an arena there is no preset area and the value is only applied.
     int64_t presetIndex = plugin->currentPresetSlot;
-    float* presetStorage = (float*)((char*)plugin->presetData + presetIndex * 0x6c + 0x138);
+    float presetScratch[0x6c / sizeof(float)];
+    float* presetStorage = plugin->presetData ?
+        (float*)((char*)plugin->presetData + presetIndex * 0x6c + 0x138) : presetScratch;
     
     switch (parameterIndex) {
         
@@ -160,6 +192,8 @@ void OTT_SetParameter(OTTPlugin* plugin, int32_t parameterIndex, float value)
             int bandIndex = parameterIndex - OTT_PARAM_LOW_BAND;
             plugin->bandControls[bandIndex] = value;
             presetStorage[parameterIndex] = value;
+            // Crossover points follow the band controls without a reset
+            UpdateCrossoverFrequencies(plugin);
             plugin->needsUpdate = true;
             break;
         }
@@ -179,11 +213,7 @@ void OTT_SetParameter(OTTPlugin* plugin, int32_t parameterIndex, float value)
             plugin->needsUpdate = true;
             
             // Update band gain outputs
-            switch (gainIndex) {
-                case 0: plugin->lowBandGain = value; break;
-                case 1: plugin->midBandGain = value; break;
-                case 2: plugin->highBandGain = value; break;
-            }
+            UpdateBandOutputGains(plugin);
             break;
         }
         
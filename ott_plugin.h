@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <math.h>
 
 // ============================================================================
@@ -13,17 +14,18 @@
 #define COMPRESSION_SCALING     0.519999981f       // Compression amount scaling
 #define UPWARD_MULT_1          2.27304697f        // Upward compression multiplier 1  
 #define UPWARD_MULT_2          0.927524984f       // Upward compression multiplier 2
-#define DELAY_BUFFER_SIZE      0x8000             // 32768 samples delay buffer
-#define NUM_FREQUENCY_BANDS    3                  // Low, Mid, High bands
+#define DELAY_BUFFER_SIZE      0x8000             // Largest block size / latency an instance can declare
+#define NUM_FREQUENCY_BANDS    3                  // Default band count: Low, Mid, High
 #define NOISE_FLOOR            1e-25              // Prevents division by zero
+#define OTT_PI                 3.14159265358979323846  // M_PI is POSIX, not ISO C
 
-// Compression algorithm constants
-#define LOG_SCALE_FACTOR        0x40215f2ced384f29    // Logarithmic scaling constant
-#define UNITY_GAIN              0x3ff0000000000000    // 1.0 in double precision
-#define MIN_GAIN_THRESHOLD      0x3f847ae147ae147b    // Minimum gain threshold  
-#define MAX_COMPRESSION_RATIO   0x4042000000000000    // Maximum compression ratio (36.0)
-#define NEGATIVE_THRESHOLD      -0x3f81000000000000   // Negative threshold limit
-#define ENVELOPE_TIME_CONSTANT  0x3fbd791c5f888822    // Time constant for envelopes
+// Compression algorithm constants (decoded from the doubles at the listed bit patterns)
+#define LOG_SCALE_FACTOR        8.6858896380650368     // 0x40215f2ced384f29: 20/ln(10), nepers to dB
+#define UNITY_GAIN              1.0                    // 0x3ff0000000000000: 1.0 in double precision
+#define MIN_GAIN_THRESHOLD      0.01                   // 0x3f847ae147ae147b: Minimum gain threshold
+#define MAX_COMPRESSION_RATIO   36.0                   // 0x4042000000000000: Maximum compression ratio
+#define NEGATIVE_THRESHOLD      -0.00830078125         // 0xbf81000000000000: Negative threshold limit
+#define ENVELOPE_TIME_CONSTANT  0.11512925464970229    // 0x3fbd791c5f888822: ln(10)/20, dB to nepers
 
 // ============================================================================
 // BIQUAD FILTER STRUCTURE
@@ -44,10 +46,268 @@ typedef struct {
     float processed_input;      // +0x28: Processed input value
 } BiquadFilter;
 
+// How the engines run the legacy crossover sections
+typedef enum {
+    OTT_FILTER_KERNEL_SERIAL = 0,   // ProcessBiquadFilter, one sample at a time
+    OTT_FILTER_KERNEL_BLOCK  = 1,   // ProcessBiquadFilterBlock, four samples per step, for chunks
+                                    // of at least OTT_BIQUAD_BLOCK_MIN_SAMPLES; matches SERIAL to
+                                    // float rounding (within 1e-5 of peak, see
+                                    // tests/test_block_kernel.c). Opt-in; both engines honour it
+} OTTFilterKernel;
+
+#ifndef OTT_DEFAULT_FILTER_KERNEL
+#define OTT_DEFAULT_FILTER_KERNEL OTT_FILTER_KERNEL_SERIAL
+#endif
+
+// Shorter chunks stay serial: the look-ahead matrices are built once per
+// chunk and only pay off over longer runs
+#define OTT_BIQUAD_BLOCK_MIN_SAMPLES    64
+
+// ============================================================================
+// TPT STATE-VARIABLE FILTER STRUCTURE
+// ============================================================================
+
+/*
+ * Trapezoidal (topology-preserving) SVF section. One section gives lowpass,
+ * bandpass, highpass and allpass outputs from the same two integrators; the
+ * LR4 crossover is built from Butterworth sections (k = sqrt(2)). Every
+ * section at one crossover point has the same coefficients, so they are
+ * kept once per point and the integrators per section.
+ */
+typedef struct {
+    float k;                    // Damping, 1/Q
+    float a1;                   // 1 / (1 + g * (g + k)), g = tan(pi * fc / fs)
+    float a2;                   // g * a1
+    float a3;                   // g * a2
+} SVFCoefficients;
+
+// Integrator state of one four-lane LR4 stage, one section per lane
+typedef struct {
+    float ic1eq[4];             // Integrator 1 state
+    float ic2eq[4];             // Integrator 2 state
+} SVFStageState;
+
+// Crossover network run by the engines
+typedef enum {
+    OTT_CROSSOVER_LEGACY = 0,       // OTT's 2nd-order sections (crossoverFilters)
+    OTT_CROSSOVER_LR4    = 1,       // Linkwitz-Riley 4th-order, bands sum to an allpass (lr4Stages)
+    OTT_CROSSOVER_LINEAR_PHASE = 2, // FIR, bands sum to a pure delay (linearPhase); adds latency
+} OTTCrossoverTopology;
+
+#ifndef OTT_DEFAULT_CROSSOVER_TOPOLOGY
+#define OTT_DEFAULT_CROSSOVER_TOPOLOGY OTT_CROSSOVER_LEGACY
+#endif
+
+// Butterworth section damping; two sections in series make one LR4 slope
+#define OTT_LR4_SECTION_DAMPING     1.41421356f
+
+/*
+ * Crossover points at the Low/Mid/High Band controls' centre (0.5). Low
+ * and High Band move their point up to OTT_CROSSOVER_EDGE_OCTAVES either
+ * way, Mid Band shifts both by up to OTT_CROSSOVER_SHIFT_OCTAVES. Changes
+ * glide over OTT_CROSSOVER_RAMP_SAMPLES in the prewarped (tan) domain.
+ */
+#define OTT_LOW_MID_CROSSOVER       200.0f
+#define OTT_MID_HIGH_CROSSOVER      2000.0f
+#define OTT_CROSSOVER_EDGE_OCTAVES  2.0f
+#define OTT_CROSSOVER_SHIFT_OCTAVES 1.0f
+#define OTT_CROSSOVER_RAMP_SAMPLES  256
+
+// ============================================================================
+// BAND LAYOUT
+// ============================================================================
+
+/*
+ * The engines split numBands bands (OTT_MIN_BANDS..OTT_MAX_BANDS, at most
+ * the instance's maxBands) at numBands - 1 crossover points, lowest first.
+ * Band b is lines 2b (left) and 2b + 1 (right) of bandBuffers and
+ * delayBuffers. The legacy network only splits NUM_FREQUENCY_BANDS bands;
+ * any other count runs on LR4.
+ */
+#define OTT_MIN_BANDS           2
+#define OTT_MAX_BANDS           8
+#define OTT_MAX_CROSSOVERS      (OTT_MAX_BANDS - 1)
+
+/*
+ * lr4Stages layout. Bands travel in stereo pairs, two bands to a stage
+ * {bL, bR, b'L, b'R}, and each crossover point p adds, in this order:
+ *   - the split section on what is left above point p - 1 (lanes 0-1).
+ *     At odd p band p - 1 sits alone in its pair and takes its allpass
+ *     at p in lanes 2-3; at even p those lanes idle;
+ *   - one allpass stage at p for every full pair of bands below p - 1,
+ *     so each band stays in phase with everything above it;
+ *   - the second Butterworth section after each split output: lowpass
+ *     (band p, lanes 0-1) and highpass (the rest, lanes 2-3), making LR4.
+ * Every section in a stage runs at that stage's point. Three bands take
+ * four stages; eight take twenty-three.
+ */
+#define OTT_LR4_STAGE_COUNT(bands)  (2 * ((bands) - 1) + ((bands) - 2) * ((bands) - 2) / 4)
+#define OTT_LR4_MAX_STAGES          OTT_LR4_STAGE_COUNT(OTT_MAX_BANDS)
+
+// ============================================================================
+// CROSSOVER COEFFICIENT CACHE
+// ============================================================================
+
+/*
+ * Everything one crossover point needs at one sample rate, for both IIR
+ * topologies (they share the prewarp). Entries are built once per
+ * (frequency, sample rate) for the whole process and never change after,
+ * so instances read them without locking (see GetCrossoverCoefficients).
+ */
+typedef struct {
+    float g;                    // tan(pi * fc / fs), as CrossoverPrewarp
+    BiquadFilter legacy;        // OTT_CROSSOVER_LEGACY section, zero state
+    SVFCoefficients lr4;        // OTT_CROSSOVER_LR4 sections
+} CrossoverCoefficients;
+
+// ============================================================================
+// LINEAR-PHASE CROSSOVER
+// ============================================================================
+
+/*
+ * Uniformly partitioned overlap-save convolution. Each crossover point is a
+ * windowed-sinc lowpass of OTT_LINEAR_PHASE_TAPS taps, split into
+ * OTT_LINEAR_PHASE_PARTITIONS partitions of one block. Band 0 is the lowest
+ * lowpass, every band above it the difference of neighbouring lowpasses,
+ * and the top band the delayed input minus the highest, so the bands sum
+ * to the input delayed by OTT_LINEAR_PHASE_LATENCY samples: one block of
+ * buffering plus the kernels' group delay. Left and right travel as the
+ * real and imaginary part of one complex FFT of OTT_LINEAR_PHASE_FFT_SIZE.
+ */
+#define OTT_LINEAR_PHASE_BLOCK          256
+#define OTT_LINEAR_PHASE_PARTITIONS     32
+#define OTT_LINEAR_PHASE_FFT_SIZE       (2 * OTT_LINEAR_PHASE_BLOCK)
+#define OTT_LINEAR_PHASE_TAPS           (OTT_LINEAR_PHASE_PARTITIONS * OTT_LINEAR_PHASE_BLOCK - 1)
+#define OTT_LINEAR_PHASE_LATENCY        (OTT_LINEAR_PHASE_BLOCK + OTT_LINEAR_PHASE_TAPS / 2)
+
+// Spectra are split: real parts in one array, imaginary parts in another.
+// Every buffer lives in the instance arena (see BindLinearPhaseCrossover);
+// the FFT plan and the kernel window are shared by the process. Kernels
+// come in two banks: the parameter thread designs into the spare one and
+// the engines swap it in at block start (see DesignLinearPhaseKernels).
+typedef struct {
+    float* kernelRe[2];         // Two banks of [point][partition][FFT_SIZE] lowpass spectra, scaled 1/FFT_SIZE
+    float* kernelIm[2];
+    float* spectraRe;           // [partition][FFT_SIZE] spectra of the last input windows, newest at head
+    float* spectraIm;
+    float* windowRe;            // Previous block then the block being filled: left
+    float* windowIm;            // ... and right
+    float* scratchRe;           // Transform / accumulator buffer
+    float* scratchIm;
+    float* outputRe;            // [point][BLOCK] last block's lowpass outputs: left
+    float* outputIm;            // ... and right
+    float* dryLeft;             // Input delayed by the latency, for the top band
+    float* dryRight;
+    float* taps;                // Kernel design / response scratch (parameter thread)
+    uint32_t maxPoints;         // Points the buffers hold; 0 when not reserved
+    uint32_t dryMask;
+    uint32_t dryIndex;
+    uint32_t dryFilled;         // Dry samples written since the last clear, up to the latency
+    uint32_t fill;              // Samples in the block being filled
+    uint32_t head;              // Partition slot of the newest input spectrum
+    uint32_t validBlocks;       // Input spectra written since the last clear, up to PARTITIONS
+    uint32_t silentBlocks;      // Consecutive all-zero input blocks, saturating
+    uint32_t activeKernels;     // Bank the engines convolve with
+    _Atomic uint32_t kernelState; // Hand-over state of the spare bank
+    float kernelSampleRate[2];  // Rate each bank was designed at; 0 = none
+    float kernelFrequencies[2][OTT_MAX_CROSSOVERS];
+} LinearPhaseCrossover;
+
+// ============================================================================
+// OVERSAMPLED GAIN STAGE
+// ============================================================================
+
+/*
+ * Runs the band gain multiply and the band sum at 2x, 4x or 8x. Up to three
+ * cascaded polyphase half-band FIRs interpolate the delayed bands together
+ * with their gains, the products are summed at the top rate, and the
+ * stereo sum is decimated back through the same half-bands. The crossover,
+ * detector and compressors stay at the base rate: only the product, whose
+ * sidebands alias when gains move fast, needs the headroom. Each vector
+ * carries two bands, (left 2j, right 2j, left 2j+1, right 2j+1), or their
+ * gains times the output level. The filters are linear-phase and the top-
+ * rate sum is padded so the stage delays by whole base samples.
+ * Every buffer lives in the instance arena (see BindGainOversampler).
+ */
+#define OTT_MAX_OVERSAMPLING_STAGES     3
+#define OTT_MAX_OVERSAMPLING            (1 << OTT_MAX_OVERSAMPLING_STAGES)
+#define OTT_OVERSAMPLING_VECTORS        OTT_MAX_BANDS   // Band then gain vectors per sample
+
+typedef struct {
+    float* upHistory[OTT_MAX_OVERSAMPLING_STAGES];   // Interpolator inputs, rings stored twice
+    float* downHistory[OTT_MAX_OVERSAMPLING_STAGES]; // Decimator input pairs, rings stored twice
+    float* pad;                 // Top-rate pairs delayed to a whole base-sample latency
+    float* lastInput;           // Band and gain vectors of the last sample
+    uint32_t upIndex[OTT_MAX_OVERSAMPLING_STAGES];
+    uint32_t downIndex[OTT_MAX_OVERSAMPLING_STAGES];
+    uint32_t padIndex;
+    uint32_t padPairs;
+    uint32_t maxStages;         // Stages the buffers hold; 0 when not reserved
+    uint32_t stages;            // Active stages, factor 1 << stages; 0 = off
+    uint32_t latency;           // Base-rate delay of the active stages
+    uint32_t flushSamples;      // Repeats of one input after which the state stops changing
+    uint32_t steadySamples;     // Repeats of lastInput so far, saturating at flushSamples
+} GainOversampler;
+
+// ============================================================================
+// GAIN CURVE TABLE
+// ============================================================================
+
+/*
+ * One compressor's static gain curve (OTT_MATH_TABLE) on a dB grid around
+ * its threshold. x is compressed_level - threshold on the main path and
+ * log_processed - threshold on the alternative path. Each cell holds the
+ * gain and processed_envelope at its start and their change across it,
+ * both taken from the branch the cell lies in, so linear interpolation
+ * never straddles a jump: the grid puts the main path's threshold and the
+ * alternative path's -NEGATIVE_THRESHOLD cut-off on a cell edge. On the
+ * main path the cells are also stretched or squeezed a little so the knee
+ * where MAX_COMPRESSION_RATIO takes over lands on an edge. The cells hold
+ * the below-threshold gain before its MIN_GAIN_THRESHOLD clamp, which the
+ * lookup applies, so the clamp's corner is exact wherever release_time
+ * puts it. Below the grid both values are exponentials in x and continue
+ * from the bottom edge; above it they hold at the top edge. Curves are
+ * built once per parameter set for the whole process and never change
+ * after (see GetGainCurve).
+ */
+#define OTT_GAIN_CURVE_CELLS_PER_DB     2       // Nominal grid density
+#define OTT_GAIN_CURVE_BELOW_DB         144     // Nominal span below the edge on the threshold / cut-off
+#define OTT_GAIN_CURVE_ABOVE_DB         48      // ... and above it
+#define OTT_GAIN_CURVE_CELLS            ((OTT_GAIN_CURVE_BELOW_DB + OTT_GAIN_CURVE_ABOVE_DB) * \
+                                         OTT_GAIN_CURVE_CELLS_PER_DB)
+
+// Cell layout
+enum {
+    OTT_GAIN_CURVE_GAIN = 0,        // Gain at the cell start
+    OTT_GAIN_CURVE_GAIN_STEP,       // ... and its change to the cell end
+    OTT_GAIN_CURVE_ENVELOPE,        // processed_envelope at the cell start
+    OTT_GAIN_CURVE_ENVELOPE_STEP,
+    OTT_GAIN_CURVE_CELL_SIZE
+};
+
+typedef struct {
+    float origin;                   // x at the start of cell 0, in dB
+    float cellsPerDb;               // Grid density, close to OTT_GAIN_CURVE_CELLS_PER_DB
+    float belowSlope;               // d(ln gain)/dx below the threshold, (release_time - 1) * tc
+    float cells[OTT_GAIN_CURVE_CELLS][OTT_GAIN_CURVE_CELL_SIZE];
+} GainCurve;
+
 // ============================================================================
 // COMPRESSOR STATE STRUCTURE
 // ============================================================================
 
+// Transcendental backend used by ProcessCompressorBand
+typedef enum {
+    OTT_MATH_LIBM = 0,              // Exact libm exp()/log()
+    OTT_MATH_FAST = 1,              // Inline polynomial kernels, < 1e-5 dB error (see ott_kernels.h)
+    OTT_MATH_TABLE = 2,             // OTT_MATH_FAST log, GainCurve lookup instead of exp(), < 0.1 dB error
+                                    // while release_time stays within 1 +/- 4 (steeper curves bend more per cell)
+} OTTMathBackend;
+
+#ifndef OTT_DEFAULT_MATH_BACKEND
+#define OTT_DEFAULT_MATH_BACKEND OTT_MATH_LIBM
+#endif
+
 typedef struct {
     // RMS detection and smoothing
     double rms_smoother;           // +0xb8: RMS level smoother
@@ -68,42 +328,243 @@ typedef struct {
     // Internal processing states
     double envelope_output;        // +0x58: Envelope follower output
     double processed_envelope;     // +0x68: Processed envelope value
+    double envelope_level;         // Linear form of log_envelope (fast math shortcut)
     
     // Additional coefficients for advanced processing
     float linear_coeff;            // +0x8:  Linear processing coefficient
     float knee_coeff;              // +0xc:  Knee/curve coefficient
     
+    // Not reset by InitializeCompressor
+    OTTMathBackend mathBackend;    // exp/log implementation
+    
+    // Curve of the current parameters under OTT_MATH_TABLE, kept in step
+    // by the parameter setters; NULL otherwise (or when the cache is full,
+    // which falls back to the OTT_MATH_FAST formulas)
+    const GainCurve* gainCurve;
+    
 } CompressorState;
 
+// Precision of the gain computer run by the engines
+typedef enum {
+    OTT_PRECISION_DOUBLE = 0,       // CompressorState / ProcessCompressorBand
+    OTT_PRECISION_FLOAT  = 1,       // CompressorStateF / ProcessCompressorBandF, < 1e-4 dB from double
+} OTTCompressorPrecision;
+
+#ifndef OTT_DEFAULT_COMPRESSOR_PRECISION
+#define OTT_DEFAULT_COMPRESSOR_PRECISION OTT_PRECISION_DOUBLE
+#endif
+
+/*
+ * Single-precision working copy of a CompressorState, same fields in the
+ * same order. The engines gather it from the double state at block start
+ * and scatter it back at block end, so parameter setters, metering and
+ * reset only ever deal with CompressorState. 64 bytes of state plus the
+ * shared gain curve pointer.
+ */
+typedef struct {
+    float rms_smoother;
+    float rms_smoothing_coeff;
+    float log_envelope;
+    float threshold;
+    float ratio_state;
+    float gain_reduction;
+    float attack_coeff;
+    float release_coeff;
+    float release_time;
+    float upward_ratio;
+    float envelope_output;
+    float processed_envelope;
+    float envelope_level;
+    float linear_coeff;
+    float knee_coeff;
+    OTTMathBackend mathBackend;
+    const GainCurve* gainCurve;
+} CompressorStateF;
+
+// ============================================================================
+// PARAMETER SMOOTHER STRUCTURE
+// ============================================================================
+
+typedef enum {
+    OTT_SMOOTHER_EXPONENTIAL = 0,   // One-pole: value += (target - value) * coeff per sample
+    OTT_SMOOTHER_LINEAR      = 1,   // Constant step, reaches each new target in rampSamples
+} OTTSmootherShape;
+
+typedef struct {
+    float value;                   // +0x0: Current value
+    float coeff;                   // +0x4: One-pole coefficient
+    float target;                  // Target of the running ramp
+    float step;                    // Linear increment per sample
+    int32_t rampSamples;           // Linear ramp length
+    int32_t rampRemaining;         // Linear steps left before value == target
+    OTTSmootherShape shape;
+    bool selfTargeting;            // Target follows value after every step (output gain)
+    bool settled;                  // Further steps leave value unchanged
+} OTTSmoother;
+
+// ============================================================================
+// ENGINE CONFIGURATION
+// ============================================================================
+
+typedef enum {
+    OTT_ENGINE_STAGED = 0,          // Reference path: peak pass, crossover into bandBuffers/
+                                    // delayBuffers, then compressor/mix pass
+    OTT_ENGINE_FUSED  = 1,          // Single pass per sample, no staging arrays in the hot loop
+} OTTEngineMode;
+
+// Host blocks are processed in chunks of at most this many samples. 256
+// keeps the staged engine's three-band buffers and delay writes (~14 KB) in L1.
+#ifndef OTT_DEFAULT_CHUNK_SIZE
+#define OTT_DEFAULT_CHUNK_SIZE  256
+#endif
+
+// Longest lookahead OTT_SetLookahead accepts. The delay is also capped at
+// the instance's maxLatencySamples, sized at creation; OTT_SetLookahead and
+// OTT_SetSampleRate return false when that cap cuts the request short.
+#define OTT_MAX_LOOKAHEAD_MS    50.0f
+
+// ============================================================================
+// INSTANCE LIMITS
+// ============================================================================
+
+/*
+ * Sizes the per-instance arena. bandBuffers hold one internal chunk, so
+ * maxBlockSize bounds processingChunkSize (host blocks of any length are
+ * still accepted). The delay ring holds a chunk plus maxLatencySamples of
+ * lookahead. Both are clamped to 1..DELAY_BUFFER_SIZE. There are two band
+ * and two delay lines per band up to maxBands (clamped to
+ * NUM_FREQUENCY_BANDS..OTT_MAX_BANDS).
+ */
+typedef struct {
+    int32_t maxBlockSize;           // Longest internal chunk
+    int32_t maxLatencySamples;      // Longest lookahead, in samples
+    int32_t maxBands;               // Most bands OTT_SetBandCount can select
+    bool linearPhase;               // Reserve OTT_CROSSOVER_LINEAR_PHASE buffers (258 KB per point plus about 232 KB)
+    bool hugePages;                 // Back arenas of 2 MB and up (pool slabs, linear phase) with huge pages
+    int32_t maxOversampling;        // Highest OTT_SetOversampling factor (1 = none, 2, 4 or 8; about 15 KB at 8)
+} OTTInstanceLimits;
+
+// Arena segments start on cache lines
+#define OTT_CACHE_LINE_SIZE     64
+
+// Preset storage carved from the arena
+#define OTT_PRESET_DATA_SIZE    0x1000
+
 // ============================================================================
 // MAIN PLUGIN STRUCTURE
 // ============================================================================
 
+/*
+ * The struct is split in two cache-line aligned blocks. The hot block holds
+ * everything the processing kernels read or write per sample or per chunk:
+ * filter, compressor and smoother state first, then the block-rate scalars.
+ * That is the working set of the default three-band legacy path; state
+ * only other networks read opens the cold block. The rest of the cold
+ * block holds raw parameters, switches, UI meters, presets and allocation
+ * bookkeeping, which only the control side touches. Field
+ * offsets noted as +0x... are from the original binary, not this layout.
+ *
+ * The hot block must start on a cache line, so an OTTPlugin has to live in
+ * static or automatic storage, or come from OTT_CreatePlugin; plain malloc
+ * only guarantees 16-byte alignment. This breaks hosts that used to
+ * malloc(sizeof(OTTPlugin)) and call OTT_Initialize: they must switch to
+ * OTT_CreatePlugin/OTT_DestroyPlugin (or aligned_alloc with
+ * _Alignof(OTTPlugin)).
+ */
 typedef struct {
+    // ========================================================================
+    // HOT ENGINE STATE
+    // ========================================================================
+    
+    // Compressor objects, one per band (+0x200-0x210: OTT's low, mid, high).
+    // Up to three bands run on bandCompressors, more on arenaCompressors;
+    // compressors points at the set in use (see SelectBandCompressors)
+    _Alignas(OTT_CACHE_LINE_SIZE)
+    CompressorState bandCompressors[NUM_FREQUENCY_BANDS];
+    CompressorState* compressors;
+    
+    // Multiband filter objects (6 filters for 3-band stereo crossover)
+    BiquadFilter crossoverFilters[6];  // +0x140-0x178: Crossover filter objects
+    
+    // Smoothing filters for parameters
+    OTTSmoother depthSmoother;    // +0x288: Depth parameter smoother
+    OTTSmoother upwardSmoother;   // +0x298: Upward ratio smoother
+    OTTSmoother outputSmoother;   // +0x2a0: Output gain smoother
+    
+    // Band processing buffers
+    float** bandBuffers;          // +0x250: Individual band audio buffers
+    float** delayBuffers;         // +0x258: Delay line buffers
+    
+    // Buffer management
+    uint32_t bufferIndex;         // +0x2a8: Current buffer position
+    uint32_t writeIndex;          // +0x2b0: Write position
+    uint32_t processingChunkSize; // Max samples per internal chunk (<= maxBlockSize)
+    uint32_t lookaheadSamples;    // Band delay behind the detector (0 = no delay lines)
+    uint32_t delayRingSize;       // Delay line length (power of two)
+    uint32_t delayRingMask;       // delayRingSize - 1
+    uint32_t delayValidSamples;   // Samples written since reset; older slots read as zero
+    uint32_t restSamples;         // Consecutive all-zero band samples (saturates at lookahead)
+    
+    // Peak detection envelopes (stereo)
+    float peakEnvelopeLeft;       // +0xf4: Left channel peak envelope
+    float peakEnvelopeRight;      // +0xf8: Right channel peak envelope
+    
+    // Smoother targets and outputs
+    float depth;                  // +0x2dc: Compression depth/amount
+    float upwardRatio;            // +0x2ec: Processed upward compression ratio
+    float currentGain;            // +0x2f4: Current gain value
+    float finalGain;              // +0x2f8: Final processed gain
+    
+    // Output gain per band (+0x238-0x240: OTT's low, mid, high)
+    float bandOutputGains[OTT_MAX_BANDS];
+    
+    // Channel configuration
+    uint32_t inputChannelIndex;   // +0x30c: Buffer the right input is read from (0 = mono)
+    uint32_t outputChannelIndex;  // +0x310: Buffer the right output is written to (0 = mono)
+    uint32_t numBands;            // Bands the engines split into
+    uint32_t maxBands;            // Bands the arena has lines for
+    
+    // Processing modes
+    OTTEngineMode engineMode;     // Block kernel used by OTT_ProcessAudio
+    OTTCompressorPrecision compressorPrecision; // Gain computer precision
+    OTTFilterKernel filterKernel; // Legacy crossover recurrence
+    OTTCrossoverTopology crossoverTopology; // Network splitting the bands
+    bool bypass;                  // +0x326: Bypass on/off
+    bool advancedMode;            // +0x248: Advanced processing mode
+    bool sleeping;                // Silent tail decayed; chunks output zeros
+    
+    // ========================================================================
+    // COLD CONTROL / UI STATE
+    // ========================================================================
+    
     // Plugin state
-    bool bypass;                    // +0x326: Bypass on/off
-    bool advancedMode;             // +0x248: Advanced processing mode
+    _Alignas(OTT_CACHE_LINE_SIZE)
     bool needsUpdate;              // Processing update flag
     
-    // Channel configuration
-    uint32_t inputChannels;        // +0x60: Number of input channels
-    uint32_t outputChannels;       // +0x64: Number of output channels  
-    uint32_t inputChannelIndex;    // +0x30c: Current input channel
-    uint32_t outputChannelIndex;   // +0x310: Current output channel
+    // Engine state the three-band legacy path never reads; it sits at the
+    // head of the cold block, next to the hot one
+    SVFCoefficients lr4Points[OTT_MAX_CROSSOVERS]; // OTT_CROSSOVER_LR4 coefficients per point
     
-    // Peak detection envelopes (stereo)
-    float peakEnvelopeLeft;        // +0xf4: Left channel peak envelope
-    float peakEnvelopeRight;       // +0xf8: Right channel peak envelope
+    // Optional network and gain stage state, in the arena
+    SVFStageState* lr4Stages;          // OTT_CROSSOVER_LR4 section state, for maxBands
+    LinearPhaseCrossover* linearPhase; // OTT_CROSSOVER_LINEAR_PHASE state; NULL when not reserved
+    GainOversampler* oversampler;      // OTT_SetOversampling state; NULL when not reserved
+    
+    // Crossover point glides. The engines copy them into locals once per
+    // chunk, and the legacy sections only retune from them per host block
+    OTTSmoother crossoverSmoothers[OTT_MAX_CROSSOVERS]; // Prewarped gain g of each crossover point
+    float crossoverTargets[OTT_MAX_CROSSOVERS]; // g for the band controls' current frequencies
+    
+    // Host channel counts; the channel indices are picked from these once
+    // per host block
+    uint32_t inputChannels;        // +0x60: Number of input channels
+    uint32_t outputChannels;       // +0x64: Number of output channels
     
-    // Main compression parameters
-    float depth;                   // +0x2dc: Compression depth/amount
+    // Raw compression parameters
     float timeControl;             // +0x2d8: Attack/release time control
     float upwardRatioRaw;          // +0x2e4: Raw upward ratio parameter (0-1)
-    float upwardRatio;             // +0x2ec: Processed upward compression ratio
-    float downwardRatioRaw;        // +0x2e8: Raw downward ratio parameter (0-1)  
+    float downwardRatioRaw;        // +0x2e8: Raw downward ratio parameter (0-1)
     float downwardRatio;           // +0x2f0: Processed downward compression ratio
-    float currentGain;             // +0x2f4: Current gain value
-    float finalGain;               // +0x2f8: Final processed gain
     
     // Band controls
     float bandControls[3];         // +0x20c: Low/Mid/High band controls
@@ -117,42 +578,72 @@ typedef struct {
     float additionalControl1;      // +0x2fc: Additional parameter 1
     float additionalControl2;      // +0x300: Additional parameter 2
     
-    // Smoothing filters for parameters
-    void* depthSmoother;          // +0x288: Depth parameter smoother
-    void* upwardSmoother;         // +0x298: Upward ratio smoother  
-    void* outputSmoother;         // +0x2a0: Output gain smoother
-    
-    // Multiband filter objects (6 filters for 3-band stereo crossover)
-    BiquadFilter crossoverFilters[6];  // +0x140-0x178: Crossover filter objects
+    // Timing setup
+    uint32_t bufferOffset;         // +0x2ac: Buffer offset
+    float lookaheadMs;             // Requested lookahead, kept across sample rate changes
+    float crossoverFrequencies[OTT_MAX_CROSSOVERS]; // Points in Hz, kept across sample rate changes
+    float sampleRate;              // Rate the filters and lookahead are set up for
     
-    // Band processing buffers
-    float** bandBuffers;          // +0x250: Individual band audio buffers
-    float** delayBuffers;         // +0x258: Delay line buffers
-    
-    // Compressor objects (3 bands)  
-    CompressorState compressorLow;    // +0x200: Low band compressor
-    CompressorState compressorMid;    // +0x208: Mid band compressor  
-    CompressorState compressorHigh;   // +0x210: High band compressor
-    
-    // Buffer management
-    uint32_t bufferIndex;         // +0x2a8: Current buffer position
-    uint32_t bufferOffset;        // +0x2ac: Buffer offset
-    uint32_t writeIndex;          // +0x2b0: Write position
-    
-    // Output gain controls (3 bands)
-    float lowBandGain;            // +0x238: Low band output gain
-    float midBandGain;            // +0x23c: Mid band output gain  
-    float highBandGain;           // +0x240: High band output gain
-    
-    // Compressor state storage (for UI display)
-    float compressorStates[12];   // +0x104-0x118: Various compressor states
+    // Compressor state storage (for UI display): numBands envelope outputs,
+    // then numBands RMS levels
+    float compressorStates[2 * OTT_MAX_BANDS]; // +0x104-0x118: Various compressor states
     
     // Preset system
-    uint32_t currentPresetSlot;   // +0x28: Current preset slot
-    void* presetData;             // +0x138: Preset storage area
+    uint32_t currentPresetSlot;    // +0x28: Current preset slot
+    void* presetData;              // +0x138: Preset storage area
+    
+    // Instance memory: bandBuffers, delayBuffers and presetData live in one arena
+    void* arena;                   // Cache-line aligned base
+    size_t arenaSize;              // Bytes reserved
+    bool arenaMapped;              // Arena came from mmap rather than aligned_alloc
+    bool arenaBorrowed;            // Arena belongs to an OTTInstancePool slab
+    uint32_t maxBlockSize;         // Length of each band buffer
+    uint32_t maxLatencySamples;    // Longest lookahead the delay ring holds
+    uint32_t linearPhasePoints;    // Crossover points the linear-phase buffers are reserved for
+    uint32_t oversamplingStages;   // Oversampling stages the arena reserves
+    CompressorState* arenaCompressors; // maxBands compressors; NULL when maxBands is three
     
 } OTTPlugin;
 
+// Layout check: the hot block stays within this many cache lines, the
+// three-band legacy path's working set. Other band counts, networks and
+// the oversampler keep their state in the arena or at the head of the
+// cold block. That is one line more than the split started with: the
+// gain-curve pointer grew each CompressorState by 8 bytes, and the band
+// count, tail and kernel fields fill the rest of the line.
+#define OTT_HOT_STATE_LINES     14
+
+_Static_assert(offsetof(OTTPlugin, needsUpdate) <= OTT_HOT_STATE_LINES * OTT_CACHE_LINE_SIZE,
+               "OTTPlugin hot engine state exceeds OTT_HOT_STATE_LINES cache lines");
+
+// ============================================================================
+// INSTANCE POOL
+// ============================================================================
+
+/*
+ * Fixed-capacity set of instances sharing one sample rate and one set of
+ * limits. Plugin structs and arenas come from two slabs allocated when the
+ * pool is created, and every instance is fully initialized up front.
+ * Acquire and release never touch the allocator: release restores the
+ * instance from the pristine copy (about 1.5 KB), rebinds it to its arena
+ * and clears its preset area, while the delay ring and the linear-phase
+ * history are cleared lazily like OTT_Reset does. The FFT plan is shared
+ * and the linear-phase kernels stay in the arena, so nothing is redesigned
+ * unless the pristine points differ from the released instance's.
+ */
+typedef struct {
+    OTTPlugin pristine;            // State every released instance returns to
+    OTTPlugin* instances;          // Slab of capacity plugins
+    void* arenaSlab;               // capacity arenas of arenaStride bytes
+    size_t arenaStride;
+    size_t arenaSlabSize;
+    bool arenaSlabMapped;
+    uint32_t* freeList;            // Stack of free instance indices
+    bool* inUse;                   // Per instance: acquired and not yet released
+    uint32_t freeCount;
+    uint32_t capacity;
+} OTTInstancePool;
+
 // ============================================================================
 // PARAMETER DEFINITIONS
 // ============================================================================
@@ -184,28 +675,139 @@ typedef enum {
 // FUNCTION DECLARATIONS
 // ============================================================================
 
-// Core processing
+// Core processing. Processing in place is supported: outputs[ch] may be
+// the same buffer as inputs[ch], or as the other input (swapped or shared
+// channels). Every input sample is read before the output sample at the
+// same index is written. Buffers that overlap at an offset are not
+// supported. inputs[1]/outputs[1] may be NULL for mono.
 void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_t sampleCount);
 
 // Filter functions
 void InitializeBiquadFilter(BiquadFilter* filter);
 float ProcessBiquadFilter(BiquadFilter* filter, float input);
+void ProcessBiquadFilterBlock(BiquadFilter* filter, const float* input, float* lowpass, float* highpass,
+                              int64_t numSamples);
 float GetBiquadLowpass(void* filterObj);
 float GetBiquadHighpass(void* filterObj);
 void CalculateBiquadCoefficients(BiquadFilter* filter, float frequency, float sampleRate);
+void CalculateBiquadCoefficientsPrewarped(BiquadFilter* filter, float tanHalfFreq);
+float CrossoverPrewarp(float frequency, float sampleRate);
+void UpdateCrossoverFrequencies(OTTPlugin* plugin);
+void SetupOTTCrossoverFilters(OTTPlugin* plugin, float sampleRate);
+void ClearLR4Stages(OTTPlugin* plugin);
+void RetuneLinearPhaseCrossover(OTTPlugin* plugin);
+void SetLegacyCrossoverGains(BiquadFilter* filters, float lowMidGain, float midHighGain);
+void SetLR4CrossoverGains(SVFCoefficients* points, int numBands, const float* gains);
+void SetSVFCoefficients(SVFCoefficients* point, float g);
+void CalculateSVFCoefficients(SVFCoefficients* point, float frequency, float sampleRate);
+void SetupLR4Crossover(SVFCoefficients* points, SVFStageState* stages, int numBands,
+                       const float* frequencies, float sampleRate);
+void ProcessLR4Crossover(const SVFCoefficients* points, SVFStageState* stages, int numBands,
+                         float left, float right, float* bands);
+const CrossoverCoefficients* GetCrossoverCoefficients(float frequency, float sampleRate,
+                                                      CrossoverCoefficients* scratch);
+
+// Linear-phase crossover
+size_t BindLinearPhaseCrossover(LinearPhaseCrossover* crossover, void* memory);
+void PrepareLinearPhaseCrossover(LinearPhaseCrossover* crossover);
+void ClearLinearPhaseCrossover(LinearPhaseCrossover* crossover);
+void DesignLinearPhaseKernels(LinearPhaseCrossover* crossover, int numBands, const float* frequencies,
+                              float sampleRate);
+void SwapLinearPhaseKernels(LinearPhaseCrossover* crossover);
+void ProcessLinearPhaseCrossover(LinearPhaseCrossover* crossover, int numBands, float left, float right,
+                                 float* bands);
+bool LinearPhaseCrossoverAtRest(const LinearPhaseCrossover* crossover);
+void SkipLinearPhaseCrossover(LinearPhaseCrossover* crossover, uint32_t samples);
+void LinearPhaseLowpassAmplitude(LinearPhaseCrossover* crossover, float frequency, float sampleRate,
+                                 float startHz, float stepHz, int32_t count, float* amplitude);
+
+// Oversampled gain stage
+size_t BindGainOversampler(GainOversampler* oversampler, void* memory);
+void ClearGainOversampler(GainOversampler* oversampler);
+void SetGainOversampling(GainOversampler* oversampler, uint32_t stages);
+void ProcessOversampledGain(GainOversampler* oversampler, int numBands, const float* bands, const float* gains,
+                            float outputLevel, float* left, float* right);
+bool GainOversamplerAtRest(const GainOversampler* oversampler, int numBands, const float* gains,
+                           float outputLevel);
+
+// Crossover response
+float CalculateFilterResponse(BiquadFilter* filter, float frequency, float sampleRate);
+int32_t OTT_GetCrossoverResponse(const OTTPlugin* plugin, float startHz, float stepHz, int32_t count,
+                                 float* magnitude, float* phase);
 
 // Compression functions  
 void InitializeCompressor(CompressorState* comp);
 double ProcessCompressorBand(CompressorState* comp, double inputPower, double outputLevel, 
                             double bandGain, double timeConstant);
+void SetCompressorParameters(CompressorState* comp, double threshold, double ratio,
+                             double attack, double release, double upward_ratio);
+void SetCompressorThreshold(CompressorState* comp, double threshold_db);
+void SetCompressorRatio(CompressorState* comp, double ratio);
+void SetCompressorTiming(CompressorState* comp, double attack_ms, double release_ms, double sample_rate);
+void SetCompressorMathBackend(CompressorState* comp, OTTMathBackend backend);
+double GetCompressorGainReduction(CompressorState* comp);
+double GetCompressorRMSLevel(CompressorState* comp);
+bool IsCompressorActive(CompressorState* comp);
+const GainCurve* GetGainCurve(const CompressorState* comp);
+void LoadCompressorStateF(CompressorStateF* dst, const CompressorState* src);
+void StoreCompressorStateF(CompressorState* dst, const CompressorStateF* src);
+float ProcessCompressorBandF(CompressorStateF* comp, float inputPower, float outputLevel,
+                             float bandGain, float timeConstant);
+
+// Parameter smoothing
+void InitializeSmoother(OTTSmoother* smoother, float value, float coeff);
+void SetSmootherLinearRamp(OTTSmoother* smoother, int32_t rampSamples);
+void SetSmootherTarget(OTTSmoother* smoother, float target);
+void SnapSmoother(OTTSmoother* smoother);
+void RenderSmootherRamp(OTTSmoother* smoother, float* ramp, int64_t numSamples);
+
+// Instance memory
+size_t ApplyInstanceLimits(OTTPlugin* plugin, float sampleRate, const OTTInstanceLimits* limits);
+size_t BindInstanceArena(OTTPlugin* plugin, void* arena);
+void SelectBandCompressors(OTTPlugin* plugin);
+void* AllocateArena(size_t size, bool hugePages, bool* mapped);
+void FreeArena(void* arena, size_t size, bool mapped);
 
 // Parameter functions
 void OTT_SetParameter(OTTPlugin* plugin, int32_t parameterIndex, float value);
+float OTT_GetParameter(OTTPlugin* plugin, int32_t parameterIndex);
+void OTT_InitializeParametersToDefaults(OTTPlugin* plugin);
+void OTT_GetParameterDisplay(int parameterIndex, float value, char* display, int maxLen);
 float CalculateCompressionRatio(float vstValue);
+double BandControlPosition(int band, int numBands);
+void UpdateBandOutputGains(OTTPlugin* plugin);
 const char* OTT_GetParameterName(int index);
 
 // Plugin management
 void OTT_Initialize(OTTPlugin* plugin, float sampleRate);
+void OTT_InitializeWithLimits(OTTPlugin* plugin, float sampleRate, const OTTInstanceLimits* limits);
+void InitializePlugin(OTTPlugin* plugin, float sampleRate, const OTTInstanceLimits* limits, void* arena);
+OTTPlugin* OTT_CreatePlugin(float sampleRate, const OTTInstanceLimits* limits);
+void OTT_DestroyPlugin(OTTPlugin* plugin);
+void OTT_Process(OTTPlugin* plugin, float** inputs, float** outputs, int32_t sampleCount);
+bool OTT_SetSampleRate(OTTPlugin* plugin, float sampleRate);
+void OTT_Reset(OTTPlugin* plugin);
+void OTT_SavePreset(OTTPlugin* plugin, int presetSlot);
+void OTT_LoadPreset(OTTPlugin* plugin, int presetSlot);
+float OTT_GetCPUUsage(OTTPlugin* plugin);
+
+// Instance pool
+OTTInstancePool* OTT_CreateInstancePool(uint32_t capacity, float sampleRate, const OTTInstanceLimits* limits);
+void OTT_DestroyInstancePool(OTTInstancePool* pool);
+OTTPlugin* OTT_AcquireInstance(OTTInstancePool* pool);
+void OTT_ReleaseInstance(OTTInstancePool* pool, OTTPlugin* plugin);
 void OTT_Cleanup(OTTPlugin* plugin);
+void OTT_SetEngineMode(OTTPlugin* plugin, OTTEngineMode mode);
+void OTT_SetMathBackend(OTTPlugin* plugin, OTTMathBackend backend);
+void OTT_SetCompressorPrecision(OTTPlugin* plugin, OTTCompressorPrecision precision);
+void OTT_SetFilterKernel(OTTPlugin* plugin, OTTFilterKernel kernel);
+void OTT_SetCrossoverTopology(OTTPlugin* plugin, OTTCrossoverTopology topology);
+void OTT_SetBandCount(OTTPlugin* plugin, int32_t numBands);
+void OTT_SetParameterRamp(OTTPlugin* plugin, int32_t rampSamples);
+void OTT_SetProcessingChunkSize(OTTPlugin* plugin, int32_t chunkSize);
+bool OTT_SetLookahead(OTTPlugin* plugin, float lookaheadMs);
+void OTT_SetOversampling(OTTPlugin* plugin, int32_t factor);
+int32_t OTT_GetLatencySamples(const OTTPlugin* plugin);
+bool OTT_IsSleeping(const OTTPlugin* plugin);
 
 #endif // OTT_PLUGIN_H
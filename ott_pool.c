@@ -0,0 +1,108 @@
+#include "ott_plugin.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// POOL SETUP
+// ============================================================================
+
+// Points a pool instance at its own arena after its struct was copied from
+// another instance
+static void BindPoolInstance(OTTInstancePool* pool, OTTPlugin* plugin, uint32_t index)
+{
+    plugin->arena = (char*)pool->arenaSlab + (size_t)index * pool->arenaStride;
+    BindInstanceArena(plugin, plugin->arena);
+    RetuneLinearPhaseCrossover(plugin);
+}
+
+OTTInstancePool* OTT_CreateInstancePool(uint32_t capacity, float sampleRate, const OTTInstanceLimits* limits)
+{
+    if (capacity == 0) return NULL;
+    
+    OTTInstancePool* pool = (OTTInstancePool*)aligned_alloc(_Alignof(OTTInstancePool),
+                                                            sizeof(OTTInstancePool));
+    if (!pool) return NULL;
+    memset(pool, 0, sizeof(OTTInstancePool));
+    pool->capacity = capacity;
+    
+    // Arena sizes are whole cache lines, so arenas can sit back to back
+    pool->arenaStride = ApplyInstanceLimits(&pool->pristine, sampleRate, limits);
+    pool->arenaSlabSize = pool->arenaStride * capacity;
+    
+    pool->instances = (OTTPlugin*)aligned_alloc(_Alignof(OTTPlugin), sizeof(OTTPlugin) * capacity);
+    pool->freeList = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+    pool->inUse = (bool*)calloc(capacity, sizeof(bool));
+    pool->arenaSlab = AllocateArena(pool->arenaSlabSize, limits && limits->hugePages, &pool->arenaSlabMapped);
+    if (!pool->instances || !pool->freeList || !pool->inUse || !pool->arenaSlab) {
+        OTT_DestroyInstancePool(pool);
+        return NULL;
+    }
+    
+    // Initialize once, then clone: all instances start identical apart
+    // from their arena
+    InitializePlugin(&pool->pristine, sampleRate, limits, pool->arenaSlab);
+    
+    for (uint32_t index = 0; index < capacity; index++) {
+        memcpy(&pool->instances[index], &pool->pristine, sizeof(OTTPlugin));
+        BindPoolInstance(pool, &pool->instances[index], index);
+        
+        // Lowest index is handed out first
+        pool->freeList[index] = capacity - 1 - index;
+    }
+    pool->freeCount = capacity;
+    
+    return pool;
+}
+
+void OTT_DestroyInstancePool(OTTInstancePool* pool)
+{
+    if (!pool) return;
+    
+    FreeArena(pool->arenaSlab, pool->arenaSlabSize, pool->arenaSlabMapped);
+    free(pool->inUse);
+    free(pool->freeList);
+    free(pool->instances);
+    free(pool);
+}
+
+// ============================================================================
+// ACQUIRE / RELEASE
+// ============================================================================
+
+// A ready-to-process instance, or NULL once all capacity instances are out
+OTTPlugin* OTT_AcquireInstance(OTTInstancePool* pool)
+{
+    if (pool->freeCount == 0) return NULL;
+    
+    uint32_t index = pool->freeList[--pool->freeCount];
+    pool->inUse[index] = true;
+    return &pool->instances[index];
+}
+
+// Returns an instance to the pool in its initial state. Instances from a
+// pool must come back here rather than through OTT_Cleanup/OTT_DestroyPlugin.
+// Anything but an instance this pool handed out and that is still out (a
+// foreign or misaligned pointer, a second release) is ignored, so the free
+// list never holds an index twice.
+void OTT_ReleaseInstance(OTTInstancePool* pool, OTTPlugin* plugin)
+{
+    if (!plugin) return;
+    
+    const uintptr_t start = (uintptr_t)pool->instances;
+    const uintptr_t address = (uintptr_t)plugin;
+    if (address < start || address - start >= (uintptr_t)pool->capacity * sizeof(OTTPlugin)) return;
+    if ((address - start) % sizeof(OTTPlugin) != 0) return;
+    
+    uint32_t index = (uint32_t)((address - start) / sizeof(OTTPlugin));
+    if (!pool->inUse[index]) return;
+    pool->inUse[index] = false;
+    
+    // Filters, compressors, smoothers, parameters and ring positions come
+    // back from the pristine copy; delayValidSamples = 0 there makes the
+    // old delay contents read as silence
+    memcpy(plugin, &pool->pristine, sizeof(OTTPlugin));
+    BindPoolInstance(pool, plugin, index);
+    memset(plugin->presetData, 0, OTT_PRESET_DATA_SIZE);
+    
+    pool->freeList[pool->freeCount++] = index;
+}
@@ -4,129 +4,887 @@
  */
 
 #include "ott_plugin.h"
+#include "ott_kernels.h"
+#include <string.h>
 
 // ============================================================================
-// MAIN AUDIO PROCESSING FUNCTION
+// SHARED HELPERS
 // ============================================================================
 
-void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_t sampleCount)
+// One step of the peak follower: jump to the sample when it reaches the
+// envelope, otherwise decay linearly towards zero
+static inline float UpdatePeakEnvelope(float envelope, float sample)
 {
-    int64_t numSamples = (int64_t)sampleCount;
+    if (sample < envelope) {
+        envelope -= ENVELOPE_DECAY_RATE;
+        if (envelope < 0.0f) envelope = 0.0f;
+        return envelope;
+    }
+    return sample;
+}
+
+// ============================================================================
+// VECTORIZED PEAK ENVELOPE DETECTION
+// ============================================================================
+
+// Smallest envelope the closed-form decay is used for. Below 2^-14 a decay
+// step can round to a tie or reach zero, so the scalar recurrence runs.
+#define PEAK_SCAN_MIN_ENVELOPE  6.103515625e-05f
+
+static inline float BinadeFloor(float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits &= 0x7f800000u;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/*
+ * Block form of UpdatePeakEnvelope, bit-identical to running the scalar
+ * follower over every sample.
+ *
+ * Between captures the envelope only decays, and inside one binade each
+ * "envelope - ENVELOPE_DECAY_RATE" rounds to the same exact step. Four
+ * samples of decay are therefore the prefix scan envelope - {0,1,2,3}*step,
+ * computed exactly in one vector op, and the group is compared against it
+ * in parallel. If no sample reaches the envelope the whole group retires
+ * with a single subtraction. Groups with a capture, a binade crossing or a
+ * tiny envelope run the scalar recurrence, after which the step is
+ * re-derived for the envelope's new binade.
+ */
+static float DetectPeakEnvelope(const float* input, int64_t numSamples, float envelope)
+{
+    const OTTVec4 laneSteps = Vec4Set(0.0f, 1.0f, 2.0f, 3.0f);
+    float step = 0.0f;
+    float binadeFloor = INFINITY;       // No valid step until the first scalar group
+    int64_t sampleIdx = 0;
     
-    // Early exit if bypassed
-    if (plugin->bypass) {
-        // Copy input to output when bypassed
-        for (int ch = 0; ch < 2; ch++) {
-            if (inputs[ch] && outputs[ch]) {
-                for (int i = 0; i < sampleCount; i++) {
-                    outputs[ch][i] = inputs[ch][i];
-                }
+    for (; sampleIdx + 4 <= numSamples; sampleIdx += 4) {
+        // Five steps of headroom keep every subtraction of the group (and the
+        // rounding of the one after it) inside the binade the step came from
+        if (envelope - 5.0f * step >= binadeFloor) {
+            OTTVec4 decayed = Vec4Sub(Vec4Splat(envelope), Vec4Mul(laneSteps, Vec4Splat(step)));
+            if (Vec4MaskNotLess(Vec4Load(input + sampleIdx), decayed) == 0) {
+                envelope -= 4.0f * step;
+                continue;
             }
         }
-        return;
+        
+        envelope = UpdatePeakEnvelope(envelope, input[sampleIdx]);
+        envelope = UpdatePeakEnvelope(envelope, input[sampleIdx + 1]);
+        envelope = UpdatePeakEnvelope(envelope, input[sampleIdx + 2]);
+        envelope = UpdatePeakEnvelope(envelope, input[sampleIdx + 3]);
+        
+        if (envelope >= PEAK_SCAN_MIN_ENVELOPE) {
+            // Exact by Sterbenz: both operands are within a factor of two
+            step = envelope - (envelope - ENVELOPE_DECAY_RATE);
+            binadeFloor = BinadeFloor(envelope);
+        } else {
+            binadeFloor = INFINITY;
+        }
     }
     
-    // ========================================================================
-    // CHANNEL SETUP
-    // ========================================================================
+    for (; sampleIdx < numSamples; sampleIdx++) {
+        envelope = UpdatePeakEnvelope(envelope, input[sampleIdx]);
+    }
+    
+    return envelope;
+}
+
+// ============================================================================
+// METERING
+// ============================================================================
+
+static void StoreMeterStates(OTTPlugin* plugin)
+{
+    const int numBands = (int)plugin->numBands;
+    for (int band = 0; band < numBands; band++) {
+        // Store final compressor states for metering/display
+        plugin->compressorStates[band] = (float)plugin->compressors[band].envelope_output *
+                                         plugin->bandOutputGains[band];
+        
+        // Store envelope followers for UI meters
+        plugin->compressorStates[numBands + band] = (float)plugin->compressors[band].rms_smoother;
+    }
+}
+
+// ============================================================================
+// DENORMAL PROTECTION
+// ============================================================================
+
+// Recursive state smaller than this (-300 dB) is flushed to zero between
+// chunks. A decaying crossover tail needs far more than one chunk to fall
+// from here into the subnormal range, so it never gets there.
+#define DENORMAL_FLUSH_THRESHOLD    1e-15f
+
+static inline float FlushDenormal(float x)
+{
+    return (fabsf(x) < DENORMAL_FLUSH_THRESHOLD) ? 0.0f : x;
+}
+
+/*
+ * Software counterpart of the FTZ/DAZ guard in OTT_Process, for callers of
+ * OTT_ProcessAudio and targets without flush-to-zero. Covers the state that
+ * decays towards zero on silence: the crossover recurrences and smoothers
+ * heading for a zero target. The LR4 stages only count while LR4 is
+ * selected; an idle network holds zero state. The compressors need
+ * nothing: rms_smoother tracks power plus NOISE_FLOOR and never falls
+ * below it.
+ */
+static void FlushDenormalState(OTTPlugin* plugin)
+{
+    for (int i = 0; i < 6; i++) {
+        plugin->crossoverFilters[i].state1 = FlushDenormal(plugin->crossoverFilters[i].state1);
+        plugin->crossoverFilters[i].state2 = FlushDenormal(plugin->crossoverFilters[i].state2);
+    }
+    const int lr4Stages = (plugin->crossoverTopology == OTT_CROSSOVER_LR4) ?
+                          OTT_LR4_STAGE_COUNT((int)plugin->numBands) : 0;
+    for (int stage = 0; stage < lr4Stages; stage++) {
+        for (int lane = 0; lane < 4; lane++) {
+            plugin->lr4Stages[stage].ic1eq[lane] = FlushDenormal(plugin->lr4Stages[stage].ic1eq[lane]);
+            plugin->lr4Stages[stage].ic2eq[lane] = FlushDenormal(plugin->lr4Stages[stage].ic2eq[lane]);
+        }
+    }
+    
+    plugin->depthSmoother.value = FlushDenormal(plugin->depthSmoother.value);
+    plugin->upwardSmoother.value = FlushDenormal(plugin->upwardSmoother.value);
+    plugin->outputSmoother.value = FlushDenormal(plugin->outputSmoother.value);
+}
+
+// ============================================================================
+// DELAY RING
+// ============================================================================
+
+/*
+ * Lazy clearing for the lookahead ring. Reset and lookahead changes only
+ * zero delayValidSamples; slots written before that hold stale bands. A
+ * chunk starting at bufferIndex reads the slots from bufferIndex -
+ * lookaheadSamples onwards, so while fewer than lookaheadSamples have been
+ * written the stale ones among them are zeroed here, before the chunk's
+ * writes. Ring sizing keeps those slots clear of the chunk's own writes.
+ * After the first lookaheadSamples after a reset this is a single compare.
+ */
+static inline void PrepareDelayRing(OTTPlugin* plugin, int64_t numSamples)
+{
+    const uint32_t lookaheadSamples = plugin->lookaheadSamples;
+    uint32_t valid = plugin->delayValidSamples;
+    
+    if (valid < lookaheadSamples) {
+        const uint32_t mask = plugin->delayRingMask;
+        uint32_t stalePos = (plugin->bufferIndex - lookaheadSamples) & mask;
+        uint32_t staleCount = lookaheadSamples - valid;
+        
+        // The stale run may wrap around the end of the ring
+        uint32_t firstRun = plugin->delayRingSize - stalePos;
+        if (firstRun > staleCount) firstRun = staleCount;
+        for (uint32_t line = 0; line < 2 * plugin->numBands; line++) {
+            memset(plugin->delayBuffers[line] + stalePos, 0, firstRun * sizeof(float));
+            memset(plugin->delayBuffers[line], 0, (staleCount - firstRun) * sizeof(float));
+        }
+        valid = lookaheadSamples;
+    }
+    
+    // Saturates well before it could wrap
+    valid += (uint32_t)numSamples;
+    plugin->delayValidSamples = (valid < plugin->delayRingSize) ? valid : plugin->delayRingSize;
+}
+
+// ============================================================================
+// BAND COMPRESSORS
+// ============================================================================
+
+/*
+ * The band compressors at the plugin's compressorPrecision. In
+ * OTT_PRECISION_FLOAT the CompressorStateF copies are gathered from the
+ * double states for the block and scattered back afterwards, and when all
+ * bands use OTT_MATH_FAST (or all OTT_MATH_TABLE) they run as
+ * CompressorBanks of four bands each (three bands: low, mid and high in
+ * lanes 0-2 of one bank). With libm the bank would call expf/logf once per
+ * lane for every branch, which costs more than the scalar calls it
+ * replaces. In OTT_PRECISION_DOUBLE the plugin's states are used directly.
+ */
+#define COMPRESSOR_BANKS    (OTT_MAX_BANDS / 4)
+
+typedef struct {
+    CompressorState* states;        // The compressors loaded from and stored back to
+    const float* outputGains;       // Band output gains, bandOutputGains
+    bool singlePrecision;
+    bool bandParallel;
+    CompressorStateF bands[OTT_MAX_BANDS];
+    CompressorBank bank[COMPRESSOR_BANKS];
+    OTTVec4 bandGains[COMPRESSOR_BANKS];
+} BandCompressors;
+
+// Lanes of one CompressorBank; bands past numBands are unused lanes
+static void GetCompressorBankLanes(BandCompressors* bands, int bank, int numBands, CompressorStateF* lanes[4])
+{
+    for (int lane = 0; lane < 4; lane++) {
+        int band = 4 * bank + lane;
+        lanes[lane] = (band < numBands) ? &bands->bands[band] : NULL;
+    }
+}
+
+// Works on compressors[0..numBands) rather than a whole plugin, so the
+// sleep probe can run a copy of just those
+static void LoadBandCompressors(BandCompressors* bands, CompressorState* compressors, const float* outputGains,
+                                OTTCompressorPrecision precision, int numBands)
+{
+    bands->states = compressors;
+    bands->outputGains = outputGains;
+    bands->singlePrecision = precision == OTT_PRECISION_FLOAT;
+    bands->bandParallel = false;
+    if (!bands->singlePrecision) return;
     
-    // Auto-detect mono input (copy to second channel)
-    if (plugin->inputChannels == 2 && !inputs[1]) {
-        plugin->inputChannelIndex = 0;
+    const OTTMathBackend backend = compressors[0].mathBackend;
+    bool sharedBackend = backend != OTT_MATH_LIBM;
+    for (int band = 0; band < numBands; band++) {
+        LoadCompressorStateF(&bands->bands[band], &compressors[band]);
+        sharedBackend = sharedBackend && bands->bands[band].mathBackend == backend;
     }
     
-    // Auto-detect mono output 
-    if (plugin->outputChannels == 2 && !outputs[1]) {
-        plugin->outputChannelIndex = 0;
+    bands->bandParallel = sharedBackend;
+    if (!bands->bandParallel) return;
+    
+    for (int bank = 0; 4 * bank < numBands; bank++) {
+        CompressorStateF* lanes[4];
+        float laneGains[4];
+        GetCompressorBankLanes(bands, bank, numBands, lanes);
+        for (int lane = 0; lane < 4; lane++) {
+            laneGains[lane] = lanes[lane] ? outputGains[4 * bank + lane] : 0.0f;
+        }
+        LoadCompressorBank(&bands->bank[bank], lanes);
+        bands->bandGains[bank] = Vec4Load(laneGains);
     }
+}
+
+static void StoreBandCompressors(BandCompressors* bands, int numBands)
+{
+    if (!bands->singlePrecision) return;
     
-    // ========================================================================
-    // PEAK DETECTION & ENVELOPE FOLLOWING  
-    // ========================================================================
+    if (bands->bandParallel) {
+        for (int bank = 0; 4 * bank < numBands; bank++) {
+            CompressorStateF* lanes[4];
+            GetCompressorBankLanes(bands, bank, numBands, lanes);
+            StoreCompressorBank(&bands->bank[bank], lanes);
+        }
+    }
+    for (int band = 0; band < numBands; band++) {
+        StoreCompressorStateF(&bands->states[band], &bands->bands[band]);
+    }
+}
+
+// Per-band gain (compression * outputLevel * band gain) for one sample.
+// power[] and gains[] have room for OTT_MAX_BANDS, a whole number of banks.
+static OTT_FORCE_INLINE void ProcessBandCompressors(BandCompressors* bands, const int numBands,
+                                                    float power[OTT_MAX_BANDS], float outputLevel,
+                                                    float gains[OTT_MAX_BANDS])
+{
+    const float timeConstant = (float)ENVELOPE_TIME_CONSTANT;
     
-    int64_t sampleIdx = 0;
-    int64_t rightChannelIdx = plugin->inputChannelIndex;
+    if (bands->bandParallel) {
+        // Unused lanes run on zero power and their gains are ignored. The
+        // lanes are gathered with Vec4Set: a vector load straight after the
+        // scalar stores that wrote power[] would stall on store forwarding.
+        for (int band = numBands; band % 4 != 0; band++) power[band] = 0.0f;
+        for (int bank = 0; 4 * bank < numBands; bank++) {
+            const float* lanes = power + 4 * bank;
+            OTTVec4 bankPower = Vec4Set(lanes[0], lanes[1], lanes[2], lanes[3]);
+            Vec4Store(gains + 4 * bank, ProcessCompressorBank(&bands->bank[bank], bankPower, outputLevel,
+                                                              bands->bandGains[bank], timeConstant));
+        }
+    } else if (bands->singlePrecision) {
+        for (int band = 0; band < numBands; band++) {
+            gains[band] = ProcessCompressorBandF(&bands->bands[band], power[band], outputLevel,
+                                                 bands->outputGains[band], timeConstant);
+        }
+    } else {
+        for (int band = 0; band < numBands; band++) {
+            gains[band] = (float)ProcessCompressorBand(&bands->states[band], power[band], outputLevel,
+                                                       bands->outputGains[band], ENVELOPE_TIME_CONSTANT);
+        }
+    }
+}
+
+// Stereo band power for the detector, bands[2b] / bands[2b + 1] = band b
+static OTT_FORCE_INLINE void GetBandPowers(const float* bands, const int numBands, float power[OTT_MAX_BANDS])
+{
+    for (int band = 0; band < numBands; band++) {
+        float left = bands[2 * band], right = bands[2 * band + 1];
+        power[band] = left * left + right * right + NOISE_FLOOR;
+    }
+}
+
+// ============================================================================
+// CROSSOVER MODULATION
+// ============================================================================
+
+static inline bool CrossoverSettled(const OTTSmoother* smoothers, int numBands)
+{
+    for (int point = 0; point < numBands - 1; point++) {
+        if (!smoothers[point].settled) return false;
+    }
+    return true;
+}
+
+/*
+ * The legacy sections are not a form that tolerates per-sample coefficient
+ * changes, so they take a moved crossover point in one step at block start
+ * (still without a state reset). The LR4 SVF sections stay stable under
+ * any trajectory of g and glide inside the engines instead.
+ */
+static void StepLegacyCrossover(OTTPlugin* plugin)
+{
+    if (CrossoverSettled(plugin->crossoverSmoothers, NUM_FREQUENCY_BANDS)) return;
+    
+    SnapSmoother(&plugin->crossoverSmoothers[0]);
+    SnapSmoother(&plugin->crossoverSmoothers[1]);
+    SetLegacyCrossoverGains(plugin->crossoverFilters, plugin->crossoverSmoothers[0].value,
+                            plugin->crossoverSmoothers[1].value);
+}
+
+// The linear-phase kernels are redesigned, not interpolated, so like the
+// legacy filters they take a moved point in one step at block start: the
+// bank the parameter thread designed for the new points is swapped in.
+// The snapped smoothers keep g in step for a later switch to LR4.
+static void StepLinearPhaseCrossover(OTTPlugin* plugin)
+{
+    const int numBands = (int)plugin->numBands;
+    for (int point = 0; point < numBands - 1; point++) {
+        SnapSmoother(&plugin->crossoverSmoothers[point]);
+    }
+    SwapLinearPhaseKernels(plugin->linearPhase);
+}
+
+// One sample of the LR4 glide on the plugin's own coefficients
+static inline void StepLR4Crossover(OTTPlugin* plugin, OTTSmoother* smoothers)
+{
+    float gains[OTT_MAX_CROSSOVERS];
+    for (int point = 0; point < (int)plugin->numBands - 1; point++) {
+        gains[point] = AdvanceSmoother(&smoothers[point]);
+    }
+    SetLR4CrossoverGains(plugin->lr4Points, (int)plugin->numBands, gains);
+}
+
+// ============================================================================
+// FUSED ENGINE - SINGLE PASS PER SAMPLE
+// ============================================================================
+
+// Smoother ramps are rendered this many samples at a time
+#define SMOOTHER_SPAN_SAMPLES   64
+
+/*
+ * Block kernel: the legacy crossover for one span, run through the chunk's
+ * kernels ahead of the sample loop, into spanBands before the processing
+ * gain. Both engines split a chunk into the same spans, so they
+ * still match bit for bit.
+ */
+static void ProcessLegacySpan(OTTPlugin* plugin, const LegacyCrossoverKernels* kernels, const float* left,
+                              const float* right, const float* upward, int64_t spanSamples,
+                              float spanBands[6][SMOOTHER_SPAN_SAMPLES])
+{
+    float spanLeft[SMOOTHER_SPAN_SAMPLES], spanRight[SMOOTHER_SPAN_SAMPLES];
+    for (int64_t spanIdx = 0; spanIdx < spanSamples; spanIdx++) {
+        spanLeft[spanIdx] = left[spanIdx] * upward[spanIdx];
+        spanRight[spanIdx] = right[spanIdx] * upward[spanIdx];
+    }
+    
+    float* const bands[6] = { spanBands[0], spanBands[1], spanBands[2], spanBands[3], spanBands[4], spanBands[5] };
+    ProcessLegacyCrossoverBlock(plugin->crossoverFilters, kernels, spanLeft, spanRight, spanSamples,
+                                plugin->advancedMode, bands);
+}
+
+static inline bool UseBlockFilters(const OTTPlugin* plugin, int64_t numSamples)
+{
+    return UseLegacyBlockKernel(plugin->filterKernel, numSamples);
+}
+
+/*
+ * Runs peak detection, the crossover, the band compressors and the output
+ * mix for each sample before moving to the next one. Band samples stay in
+ * registers instead of round-tripping through bandBuffers, and only pass
+ * through delayBuffers when lookahead is on. Smoother/envelope state is
+ * kept in locals for the whole block. The arithmetic is the same as the
+ * staged path, sample for sample, so both engines produce identical output
+ * (UseLegacyBlockKernel picks the same legacy crossover kernel for both).
+ *
+ * numBands must be a constant: the body is instantiated once per band
+ * count below, so every per-band loop unrolls and the band arrays stay in
+ * registers.
+ */
+static OTT_FORCE_INLINE void ProcessAudioFusedBands(OTTPlugin* plugin, float** inputs, float** outputs,
+                                                    int64_t numSamples, int64_t rightChannelIdx,
+                                                    const int numBands)
+{
+    const float* leftIn = inputs[0];
+    const float* rightIn = inputs[rightChannelIdx];
+    float* leftOut = outputs[0];
+    float* rightOut = outputs[plugin->outputChannelIndex];
+    
+    // Legacy crossover filters run as two SoA banks: the filters fed by the
+    // input (0, 1, 4, 5) and the second low/mid stage (2, 3). Only the
+    // selected topology is loaded, and only three bands can be legacy.
+    // Under the block kernel they run per span on the filters themselves.
+    static const int inputStageLanes[4] = { 0, 1, 4, 5 };
+    static const int secondStageLanes[4] = { 2, 3, OTT_BANK_UNUSED_LANE, OTT_BANK_UNUSED_LANE };
+    const bool linearPhase = plugin->crossoverTopology == OTT_CROSSOVER_LINEAR_PHASE;
+    const bool lr4 = !linearPhase &&
+                     (numBands != NUM_FREQUENCY_BANDS || plugin->crossoverTopology == OTT_CROSSOVER_LR4);
+    const bool blockFilters = !lr4 && !linearPhase && UseBlockFilters(plugin, numSamples);
+    const bool legacyBanks = !lr4 && !linearPhase && !blockFilters;
+    const int points = numBands - 1;
+    BiquadFilterBank inputStage, secondStage;
+    BiquadBankOutput inputTaps, secondTaps;
+    LR4CrossoverBank lr4Bank;
+    LegacyCrossoverKernels legacyKernels;
+    OTTSmoother crossoverSmoothers[OTT_MAX_CROSSOVERS];
+    bool crossoverMoved = false;
+    for (int point = 0; point < points; point++) {
+        crossoverSmoothers[point] = plugin->crossoverSmoothers[point];
+    }
+    if (lr4) {
+        LoadLR4CrossoverBank(&lr4Bank, plugin->lr4Points, plugin->lr4Stages, numBands);
+    } else if (legacyBanks) {
+        LoadBiquadFilterBank(&inputStage, plugin->crossoverFilters, inputStageLanes);
+        LoadBiquadFilterBank(&secondStage, plugin->crossoverFilters, secondStageLanes);
+    } else if (blockFilters) {
+        BuildLegacyCrossoverKernels(&legacyKernels, plugin->crossoverFilters);
+    }
+    
+    const bool advanced = plugin->advancedMode;
+    const bool oversampled = plugin->oversampler && plugin->oversampler->stages > 0;
+    BandCompressors compressors;
+    LoadBandCompressors(&compressors, plugin->compressors, plugin->bandOutputGains, plugin->compressorPrecision,
+                        numBands);
+    
+    // Lookahead ring: bands are written at bufferIndex and mixed from
+    // lookaheadSamples behind it; the input goes to the two lines after
+    // the last band line the arena has
+    float* const* delay = plugin->delayBuffers;
+    float* const* dryDelay = plugin->delayBuffers + 2 * plugin->maxBands;
+    const uint32_t lookaheadSamples = plugin->lookaheadSamples;
+    const bool lookahead = lookaheadSamples > 0;
+    const uint32_t delayRingMask = plugin->delayRingMask;
+    uint32_t bufferIndex = plugin->bufferIndex;
+    
+    // Pull per-block state into locals
     float leftEnvelope = plugin->peakEnvelopeLeft;
     float rightEnvelope = plugin->peakEnvelopeRight;
+    OTTSmoother depthSmoother = plugin->depthSmoother;
+    OTTSmoother upwardSmoother = plugin->upwardSmoother;
+    OTTSmoother outputSmoother = plugin->outputSmoother;
     
-    // Choose optimized loop based on sample count
-    if (numSamples < 4) {
-        // Process samples one by one (small buffers)
-        if (sampleCount > 0) {
-            do {
-                // Left channel peak detection
-                float leftSample = inputs[0][sampleIdx];
-                if (leftSample < leftEnvelope) {
-                    leftEnvelope -= ENVELOPE_DECAY_RATE;
-                    if (leftEnvelope < 0.0f) {
-                        leftEnvelope = 0.0f;
+    float depthRamp[SMOOTHER_SPAN_SAMPLES];
+    float upwardRamp[SMOOTHER_SPAN_SAMPLES];
+    float outputRamp[SMOOTHER_SPAN_SAMPLES];
+    float crossoverRamps[OTT_MAX_CROSSOVERS][SMOOTHER_SPAN_SAMPLES];
+    float spanBands[6][SMOOTHER_SPAN_SAMPLES];
+    
+    for (int64_t spanStart = 0; spanStart < numSamples; spanStart += SMOOTHER_SPAN_SAMPLES) {
+        int64_t spanEnd = spanStart + SMOOTHER_SPAN_SAMPLES;
+        if (spanEnd > numSamples) spanEnd = numSamples;
+        
+        // Parameter smoothing: ramps while any smoother moves, otherwise the
+        // settled values are used as constants
+        const bool ramping = !(depthSmoother.settled && upwardSmoother.settled && outputSmoother.settled);
+        if (ramping) {
+            RenderSmootherRamp(&depthSmoother, depthRamp, spanEnd - spanStart);
+            RenderSmootherRamp(&upwardSmoother, upwardRamp, spanEnd - spanStart);
+            RenderSmootherRamp(&outputSmoother, outputRamp, spanEnd - spanStart);
+        }
+        
+        // Crossover points glide per sample; only LR4 runs the ramps (the
+        // legacy filters and linear-phase kernels were stepped to their
+        // target at block start)
+        const bool crossoverRamping = lr4 && !CrossoverSettled(crossoverSmoothers, numBands);
+        if (crossoverRamping) {
+            for (int point = 0; point < points; point++) {
+                RenderSmootherRamp(&crossoverSmoothers[point], crossoverRamps[point], spanEnd - spanStart);
+            }
+            crossoverMoved = true;
+        }
+        
+        float depthState = depthSmoother.value;
+        float upwardState = upwardSmoother.value;
+        float outputState = outputSmoother.value;
+        
+        if (blockFilters) {
+            if (!ramping) {
+                for (int64_t spanIdx = 0; spanIdx < spanEnd - spanStart; spanIdx++) {
+                    upwardRamp[spanIdx] = upwardState;
+                }
+            }
+            ProcessLegacySpan(plugin, &legacyKernels, leftIn + spanStart, rightIn + spanStart, upwardRamp,
+                              spanEnd - spanStart, spanBands);
+        }
+        
+        for (int64_t sampleIdx = spanStart; sampleIdx < spanEnd; sampleIdx++) {
+            float leftSample = leftIn[sampleIdx];
+            float rightSample = rightIn[sampleIdx];
+            
+            leftEnvelope = UpdatePeakEnvelope(leftEnvelope, leftSample);
+            rightEnvelope = UpdatePeakEnvelope(rightEnvelope, rightSample);
+            
+            if (ramping) {
+                depthState = depthRamp[sampleIdx - spanStart];
+                upwardState = upwardRamp[sampleIdx - spanStart];
+                outputState = outputRamp[sampleIdx - spanStart];
+            }
+            
+            float processingGain = depthState * COMPRESSION_SCALING + 1.0f;
+            float leftInput = leftSample * upwardState;
+            float rightInput = rightSample * upwardState;
+            
+            // Crossover: lanes are {L, R, L, R}; bands[2b] / bands[2b + 1]
+            // are band b's left / right
+            OTTVec4 stereoInput = Vec4Set(leftInput, rightInput, leftInput, rightInput);
+            OTTVec4 bandGain = Vec4Splat(processingGain);
+            float bands[2 * OTT_MAX_BANDS];
+            
+            if (linearPhase) {
+                ProcessLinearPhaseCrossover(plugin->linearPhase, numBands, leftInput, rightInput, bands);
+                for (int line = 0; line < 2 * numBands; line++) {
+                    bands[line] *= processingGain;
+                }
+                for (int band = 1; !advanced && band < numBands - 1; band++) {
+                    bands[2 * band] = bands[2 * band + 1] = 0.0f;
+                }
+            } else if (lr4) {
+                OTTVec4 bandPairs[OTT_MAX_BANDS / 2];
+                if (crossoverRamping) {
+                    float gains[OTT_MAX_CROSSOVERS];
+                    for (int point = 0; point < points; point++) {
+                        gains[point] = crossoverRamps[point][sampleIdx - spanStart];
                     }
-                } else {
-                    leftEnvelope = leftSample;
+                    SetLR4CrossoverBankGains(&lr4Bank, numBands, gains);
                 }
+                ProcessLR4CrossoverBank(&lr4Bank, numBands, stereoInput, bandPairs);
+                for (int pair = 0; 2 * pair < numBands; pair++) {
+                    Vec4Store(bands + 4 * pair, Vec4Mul(bandPairs[pair], bandGain));
+                }
+                // Simple mode only keeps the outer bands
+                for (int band = 1; !advanced && band < numBands - 1; band++) {
+                    bands[2 * band] = bands[2 * band + 1] = 0.0f;
+                }
+            } else if (legacyBanks) {
+                float lowBand[4], midBand[4], highBand[4];
+                inputTaps = ProcessBiquadFilterBank(&inputStage, stereoInput);
+                Vec4Store(highBand, Vec4Mul(GetBiquadBankHighpass(&inputStage, &inputTaps), bandGain));
                 
-                // Right channel peak detection  
-                float rightSample = inputs[rightChannelIdx][sampleIdx];
-                if (rightSample < rightEnvelope) {
-                    rightEnvelope -= ENVELOPE_DECAY_RATE;
-                    if (rightEnvelope < 0.0f) {
-                        rightEnvelope = 0.0f;
-                    }
+                if (advanced) {
+                    secondTaps = ProcessBiquadFilterBank(&secondStage, stereoInput);
+                    Vec4Store(lowBand, Vec4Mul(GetBiquadBankLowpass(&inputTaps), bandGain));
+                    Vec4Store(midBand, Vec4Mul(GetBiquadBankHighpass(&secondStage, &secondTaps), bandGain));
                 } else {
-                    rightEnvelope = rightSample;
+                    // Simple mode cascades the low split and has no mid band
+                    secondTaps = ProcessBiquadFilterBank(&secondStage, GetBiquadBankLowpass(&inputTaps));
+                    Vec4Store(lowBand, Vec4Mul(GetBiquadBankLowpass(&secondTaps), bandGain));
+                    midBand[0] = midBand[1] = 0.0f;
                 }
                 
-                sampleIdx++;
-            } while (sampleIdx < numSamples);
-        }
-    } else {
-        // Process 4 samples at a time (SIMD optimized)
-        do {
-            // Process 4 samples in parallel
-            for (int offset = 0; offset < 4; offset++) {
-                // Left channel samples
-                float leftSample = inputs[0][sampleIdx + offset];
-                if (leftSample < leftEnvelope) {
-                    leftEnvelope -= ENVELOPE_DECAY_RATE;
-                    if (leftEnvelope < 0.0f) leftEnvelope = 0.0f;
-                } else {
-                    leftEnvelope = leftSample;
+                bands[0] = lowBand[0];
+                bands[1] = lowBand[1];
+                bands[2] = midBand[0];
+                bands[3] = midBand[1];
+                bands[4] = highBand[2];
+                bands[5] = highBand[3];
+            } else {
+                for (int line = 0; line < 6; line++) {
+                    bands[line] = spanBands[line][sampleIdx - spanStart] * processingGain;
+                }
+                if (!advanced) {
+                    bands[2] = bands[3] = 0.0f;
+                }
+            }
+            
+            // Band compression
+            float power[OTT_MAX_BANDS], gains[OTT_MAX_BANDS];
+            GetBandPowers(bands, numBands, power);
+            ProcessBandCompressors(&compressors, numBands, power, outputState, gains);
+            
+            if (lookahead) {
+                uint32_t readIndex = (bufferIndex - lookaheadSamples) & delayRingMask;
+                for (int line = 0; line < 2 * numBands; line++) {
+                    delay[line][bufferIndex] = bands[line];
                 }
+                dryDelay[0][bufferIndex] = leftSample;
+                dryDelay[1][bufferIndex] = rightSample;
                 
-                // Right channel samples
-                float rightSample = inputs[rightChannelIdx][sampleIdx + offset];
-                if (rightSample < rightEnvelope) {
-                    rightEnvelope -= ENVELOPE_DECAY_RATE; 
-                    if (rightEnvelope < 0.0f) rightEnvelope = 0.0f;
-                } else {
-                    rightEnvelope = rightSample;
+                for (int line = 0; line < 2 * numBands; line++) {
+                    bands[line] = delay[line][readIndex];
                 }
+                bufferIndex = (bufferIndex + 1) & delayRingMask;
             }
             
-            sampleIdx += 4;
-        } while (sampleIdx < numSamples - 3);
-        
-        // Process remaining samples
-        while (sampleIdx < numSamples) {
-            float leftSample = inputs[0][sampleIdx];
-            if (leftSample < leftEnvelope) {
-                leftEnvelope -= ENVELOPE_DECAY_RATE;
-                if (leftEnvelope < 0.0f) leftEnvelope = 0.0f;
+            // Mix
+            if (oversampled) {
+                float finalLeft, finalRight;
+                ProcessOversampledGain(plugin->oversampler, numBands, bands, gains, outputState,
+                                       &finalLeft, &finalRight);
+                leftOut[sampleIdx] = finalLeft;
+                rightOut[sampleIdx] = finalRight;
             } else {
-                leftEnvelope = leftSample;
+                float finalLeft = bands[0] * gains[0];
+                float finalRight = bands[1] * gains[0];
+                for (int band = 1; band < numBands; band++) {
+                    finalLeft += bands[2 * band] * gains[band];
+                    finalRight += bands[2 * band + 1] * gains[band];
+                }
+                
+                leftOut[sampleIdx] = finalLeft * outputState;
+                rightOut[sampleIdx] = finalRight * outputState;
+            }
+        }
+    }
+    
+    // Write state back
+    if (lr4) {
+        StoreLR4CrossoverBank(&lr4Bank, plugin->lr4Stages, numBands);
+        if (crossoverMoved) {
+            float gains[OTT_MAX_CROSSOVERS];
+            for (int point = 0; point < points; point++) {
+                gains[point] = crossoverSmoothers[point].value;
+            }
+            SetLR4CrossoverGains(plugin->lr4Points, numBands, gains);
+        }
+    } else if (legacyBanks) {
+        StoreBiquadFilterBank(&inputStage, &inputTaps, plugin->crossoverFilters, inputStageLanes);
+        StoreBiquadFilterBank(&secondStage, &secondTaps, plugin->crossoverFilters, secondStageLanes);
+    }
+    StoreBandCompressors(&compressors, numBands);
+    plugin->peakEnvelopeLeft = leftEnvelope;
+    plugin->peakEnvelopeRight = rightEnvelope;
+    plugin->bufferIndex = bufferIndex;
+    plugin->writeIndex = (bufferIndex - lookaheadSamples) & delayRingMask;
+    plugin->depthSmoother = depthSmoother;
+    plugin->upwardSmoother = upwardSmoother;
+    plugin->outputSmoother = outputSmoother;
+    for (int point = 0; point < points; point++) {
+        plugin->crossoverSmoothers[point] = crossoverSmoothers[point];
+    }
+    plugin->currentGain = upwardSmoother.value;
+    plugin->finalGain = outputSmoother.value;
+}
+
+#define FUSED_ENGINE(bands) \
+    static void ProcessAudioFused##bands(OTTPlugin* plugin, float** inputs, float** outputs, \
+                                         int64_t numSamples, int64_t rightChannelIdx) \
+    { ProcessAudioFusedBands(plugin, inputs, outputs, numSamples, rightChannelIdx, bands); }
+FUSED_ENGINE(2)
+FUSED_ENGINE(3)
+FUSED_ENGINE(4)
+FUSED_ENGINE(5)
+FUSED_ENGINE(6)
+FUSED_ENGINE(7)
+FUSED_ENGINE(8)
+#undef FUSED_ENGINE
+
+static void ProcessAudioFused(OTTPlugin* plugin, float** inputs, float** outputs,
+                              int64_t numSamples, int64_t rightChannelIdx)
+{
+    switch (plugin->numBands) {
+        case 2: ProcessAudioFused2(plugin, inputs, outputs, numSamples, rightChannelIdx); break;
+        case 4: ProcessAudioFused4(plugin, inputs, outputs, numSamples, rightChannelIdx); break;
+        case 5: ProcessAudioFused5(plugin, inputs, outputs, numSamples, rightChannelIdx); break;
+        case 6: ProcessAudioFused6(plugin, inputs, outputs, numSamples, rightChannelIdx); break;
+        case 7: ProcessAudioFused7(plugin, inputs, outputs, numSamples, rightChannelIdx); break;
+        case 8: ProcessAudioFused8(plugin, inputs, outputs, numSamples, rightChannelIdx); break;
+        default: ProcessAudioFused3(plugin, inputs, outputs, numSamples, rightChannelIdx); break;
+    }
+}
+
+// ============================================================================
+// STAGED ENGINE - REFERENCE THREE-PASS PATH
+// ============================================================================
+
+// One sample of LR4, linear-phase or block-kernel legacy bands, staged
+// into bandBuffers like the serial legacy split; without innerBands
+// (simple mode) only the outer bands are kept
+static inline void StageBands(OTTPlugin* plugin, int64_t sampleIdx, const float* bands,
+                              float processingGain, bool innerBands)
+{
+    const int numBands = (int)plugin->numBands;
+    for (int line = 0; line < 2 * numBands; line++) {
+        plugin->bandBuffers[line][sampleIdx] = bands[line] * processingGain;
+    }
+    for (int line = 2; !innerBands && line < 2 * (numBands - 1); line++) {
+        plugin->bandBuffers[line][sampleIdx] = 0.0f;
+    }
+}
+
+// Block-kernel legacy crossover for the span starting at spanStart (the
+// fused engine's spans); the upward smoother is run ahead on a copy
+static void StageLegacySpan(OTTPlugin* plugin, const LegacyCrossoverKernels* kernels, float** inputs,
+                            int64_t rightChannelIdx, int64_t spanStart, int64_t numSamples,
+                            OTTSmoother upwardSmoother, float spanBands[6][SMOOTHER_SPAN_SAMPLES])
+{
+    int64_t spanSamples = numSamples - spanStart;
+    if (spanSamples > SMOOTHER_SPAN_SAMPLES) spanSamples = SMOOTHER_SPAN_SAMPLES;
+    
+    float upward[SMOOTHER_SPAN_SAMPLES];
+    for (int64_t spanIdx = 0; spanIdx < spanSamples; spanIdx++) {
+        upward[spanIdx] = AdvanceSmoother(&upwardSmoother);
+    }
+    ProcessLegacySpan(plugin, kernels, inputs[0] + spanStart, inputs[rightChannelIdx] + spanStart, upward,
+                      spanSamples, spanBands);
+}
+
+// Copies one sample of every band line, and the input, into the delay ring
+static inline void WriteDelayLines(OTTPlugin* plugin, float** inputs, int64_t sampleIdx, int64_t rightChannelIdx)
+{
+    int bufferPos = plugin->bufferIndex;
+    for (uint32_t line = 0; line < 2 * plugin->numBands; line++) {
+        plugin->delayBuffers[line][bufferPos] = plugin->bandBuffers[line][sampleIdx];
+    }
+    
+    // Store original input in delay buffer
+    plugin->delayBuffers[2 * plugin->maxBands][bufferPos] = inputs[0][sampleIdx];
+    plugin->delayBuffers[2 * plugin->maxBands + 1][bufferPos] = inputs[rightChannelIdx][sampleIdx];
+    
+    // Advance buffer position
+    plugin->bufferIndex++;
+    if (plugin->bufferIndex >= plugin->delayRingSize) {
+        plugin->bufferIndex = 0;
+    }
+}
+
+// Compressor pass: detector from bandBuffers, mix from bandBuffers or the
+// delay ring. Like the fused engine it is instantiated per band count so the
+// per-band loops unroll.
+static OTT_FORCE_INLINE void ProcessStagedCompressorsBands(OTTPlugin* plugin, float** outputs, int64_t numSamples,
+                                                           bool lookahead, OTTSmoother* smoother,
+                                                           const int numBands)
+{
+    OTTSmoother outputSmoother = *smoother;
+    const bool oversampled = plugin->oversampler && plugin->oversampler->stages > 0;
+    BandCompressors compressors;
+    LoadBandCompressors(&compressors, plugin->compressors, plugin->bandOutputGains, plugin->compressorPrecision,
+                        numBands);
+    
+    for (int64_t sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+        // ====================================================================
+        // ADVANCED COMPRESSION ALGORITHM (N-BAND)
+        // ====================================================================
+        
+        // Smooth output gain
+        float smoothedOutput = AdvanceSmoother(&outputSmoother);
+        plugin->finalGain = smoothedOutput;
+        
+        // Current band samples drive the detector
+        float bands[2 * OTT_MAX_BANDS];
+        for (int line = 0; line < 2 * numBands; line++) {
+            bands[line] = plugin->bandBuffers[line][sampleIdx];
+        }
+        
+        // Calculate RMS power for each band
+        float power[OTT_MAX_BANDS];
+        GetBandPowers(bands, numBands, power);
+        
+        // Get delayed band samples from delay buffers
+        if (lookahead) {
+            int readIndex = plugin->writeIndex;
+            for (int line = 0; line < 2 * numBands; line++) {
+                bands[line] = plugin->delayBuffers[line][readIndex];
             }
             
-            float rightSample = inputs[rightChannelIdx][sampleIdx];
-            if (rightSample < rightEnvelope) {
-                rightEnvelope -= ENVELOPE_DECAY_RATE;
-                if (rightEnvelope < 0.0f) rightEnvelope = 0.0f;
-            } else {
-                rightEnvelope = rightSample;
+            // Advance read position
+            plugin->writeIndex++;
+            if (plugin->writeIndex >= plugin->delayRingSize) {
+                plugin->writeIndex = 0;
+            }
+        }
+        
+        // ================================================================
+        // COMPRESSION PROCESSING
+        // ================================================================
+        
+        float gains[OTT_MAX_BANDS];
+        ProcessBandCompressors(&compressors, numBands, power, smoothedOutput, gains);
+        
+        // ================================================================
+        // OUTPUT MIXING & FINAL GAIN
+        // ================================================================
+        
+        float finalLeft, finalRight;
+        if (oversampled) {
+            // Gains, mix and final gain at the oversampled rate
+            ProcessOversampledGain(plugin->oversampler, numBands, bands, gains, plugin->finalGain,
+                                   &finalLeft, &finalRight);
+        } else {
+            // Apply gain reduction to each band
+            for (int line = 0; line < 2 * numBands; line++) {
+                bands[line] *= gains[line / 2];
             }
             
-            sampleIdx++;
+            // Mix all bands together
+            finalLeft = bands[0];
+            finalRight = bands[1];
+            for (int band = 1; band < numBands; band++) {
+                finalLeft += bands[2 * band];
+                finalRight += bands[2 * band + 1];
+            }
+            finalLeft *= plugin->finalGain;
+            finalRight *= plugin->finalGain;
         }
+        
+        // Write to output buffers
+        outputs[0][sampleIdx] = finalLeft;
+        outputs[plugin->outputChannelIndex][sampleIdx] = finalRight;
+    }
+    
+    StoreBandCompressors(&compressors, numBands);
+    *smoother = outputSmoother;
+}
+
+#define STAGED_COMPRESSORS(bands) \
+    static void ProcessStagedCompressors##bands(OTTPlugin* plugin, float** outputs, int64_t numSamples, \
+                                                bool lookahead, OTTSmoother* smoother) \
+    { ProcessStagedCompressorsBands(plugin, outputs, numSamples, lookahead, smoother, bands); }
+STAGED_COMPRESSORS(2)
+STAGED_COMPRESSORS(3)
+STAGED_COMPRESSORS(4)
+STAGED_COMPRESSORS(5)
+STAGED_COMPRESSORS(6)
+STAGED_COMPRESSORS(7)
+STAGED_COMPRESSORS(8)
+#undef STAGED_COMPRESSORS
+
+static void ProcessStagedCompressors(OTTPlugin* plugin, float** outputs, int64_t numSamples,
+                                     bool lookahead, OTTSmoother* smoother)
+{
+    switch (plugin->numBands) {
+        case 2: ProcessStagedCompressors2(plugin, outputs, numSamples, lookahead, smoother); break;
+        case 4: ProcessStagedCompressors4(plugin, outputs, numSamples, lookahead, smoother); break;
+        case 5: ProcessStagedCompressors5(plugin, outputs, numSamples, lookahead, smoother); break;
+        case 6: ProcessStagedCompressors6(plugin, outputs, numSamples, lookahead, smoother); break;
+        case 7: ProcessStagedCompressors7(plugin, outputs, numSamples, lookahead, smoother); break;
+        case 8: ProcessStagedCompressors8(plugin, outputs, numSamples, lookahead, smoother); break;
+        default: ProcessStagedCompressors3(plugin, outputs, numSamples, lookahead, smoother); break;
     }
+}
+
+static void ProcessAudioStaged(OTTPlugin* plugin, float** inputs, float** outputs,
+                               int64_t numSamples, int64_t rightChannelIdx)
+{
+    // Without lookahead the delay lines are never touched
+    const uint32_t lookaheadSamples = plugin->lookaheadSamples;
+    const bool lookahead = lookaheadSamples > 0;
+    const uint32_t chunkStart = plugin->bufferIndex;
+    const bool lr4 = plugin->crossoverTopology == OTT_CROSSOVER_LR4;
+    const bool linearPhase = plugin->crossoverTopology == OTT_CROSSOVER_LINEAR_PHASE;
+    const bool blockFilters = !lr4 && !linearPhase && UseBlockFilters(plugin, numSamples);
+    const int numBands = (int)plugin->numBands;
+    float bands[2 * OTT_MAX_BANDS];
+    float spanBands[6][SMOOTHER_SPAN_SAMPLES];
+    LegacyCrossoverKernels legacyKernels;
+    if (blockFilters) BuildLegacyCrossoverKernels(&legacyKernels, plugin->crossoverFilters);
+    
+    // ========================================================================
+    // PEAK DETECTION & ENVELOPE FOLLOWING  
+    // ========================================================================
+    
+    float leftEnvelope = DetectPeakEnvelope(inputs[0], numSamples, plugin->peakEnvelopeLeft);
+    float rightEnvelope = DetectPeakEnvelope(inputs[rightChannelIdx], numSamples, plugin->peakEnvelopeRight);
     
     // Store updated envelopes
     plugin->peakEnvelopeLeft = leftEnvelope;
@@ -136,7 +894,15 @@ void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_
     // MAIN PROCESSING LOOP
     // ========================================================================
     
-    if (sampleCount <= 0) return;
+    // Typed smoothers advance on local copies and are written back at the end
+    OTTSmoother depthSmoother = plugin->depthSmoother;
+    OTTSmoother upwardSmoother = plugin->upwardSmoother;
+    OTTSmoother outputSmoother = plugin->outputSmoother;
+    OTTSmoother crossoverSmoothers[OTT_MAX_CROSSOVERS];
+    for (int point = 0; point < numBands - 1; point++) {
+        crossoverSmoothers[point] = plugin->crossoverSmoothers[point];
+    }
+    const bool crossoverRamping = lr4 && !CrossoverSettled(crossoverSmoothers, numBands);
     
     if (!plugin->advancedMode) {
         // ====================================================================
@@ -144,18 +910,14 @@ void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_
         // ====================================================================
         
         for (int64_t sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
-            // Smooth compression parameters
-            float depthTarget = plugin->depth;
-            float* depthSmoother = (float*)plugin->depthSmoother;
-            float smoothedDepth = depthTarget - depthSmoother[0];
-            smoothedDepth = smoothedDepth * depthSmoother[1] + depthSmoother[0];
-            depthSmoother[0] = smoothedDepth;
+            if (blockFilters && sampleIdx % SMOOTHER_SPAN_SAMPLES == 0) {
+                StageLegacySpan(plugin, &legacyKernels, inputs, rightChannelIdx, sampleIdx, numSamples,
+                                upwardSmoother, spanBands);
+            }
             
-            float upwardTarget = plugin->upwardRatio; 
-            float* upwardSmoother = (float*)plugin->upwardSmoother;
-            float smoothedUpward = upwardTarget - upwardSmoother[0];
-            smoothedUpward = smoothedUpward * upwardSmoother[1] + upwardSmoother[0];
-            upwardSmoother[0] = smoothedUpward;
+            // Smooth compression parameters
+            float smoothedDepth = AdvanceSmoother(&depthSmoother);
+            float smoothedUpward = AdvanceSmoother(&upwardSmoother);
             plugin->currentGain = smoothedUpward;
             
             // Scale compression amounts
@@ -163,38 +925,49 @@ void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_
             float leftProcessingGain = smoothedUpward * inputs[0][sampleIdx];
             float rightProcessingGain = smoothedUpward * inputs[rightChannelIdx][sampleIdx];
             
-            // Apply multiband filtering
-            ProcessBiquadFilter(&plugin->crossoverFilters[0], leftProcessingGain);
-            ProcessBiquadFilter(&plugin->crossoverFilters[1], rightProcessingGain);
-            ProcessBiquadFilter(&plugin->crossoverFilters[2], GetBiquadLowpass(&plugin->crossoverFilters[0]));
-            ProcessBiquadFilter(&plugin->crossoverFilters[3], GetBiquadLowpass(&plugin->crossoverFilters[1]));
-            
-            // Store band outputs  
-            plugin->bandBuffers[0][sampleIdx] = GetBiquadLowpass(&plugin->crossoverFilters[2]) * processingGain;
-            plugin->bandBuffers[1][sampleIdx] = GetBiquadLowpass(&plugin->crossoverFilters[3]) * processingGain;
-            
-            // Process additional filter stages
-            ProcessBiquadFilter(&plugin->crossoverFilters[4], leftProcessingGain);
-            ProcessBiquadFilter(&plugin->crossoverFilters[5], rightProcessingGain);
-            
-            // Store high frequency bands
-            plugin->bandBuffers[4][sampleIdx] = GetBiquadHighpass(&plugin->crossoverFilters[4]) * processingGain;
-            plugin->bandBuffers[5][sampleIdx] = GetBiquadHighpass(&plugin->crossoverFilters[5]) * processingGain;
-            
-            // Update delay buffers  
-            int bufferPos = plugin->bufferIndex;
-            for (int band = 0; band < 6; band++) {
-                plugin->delayBuffers[band][bufferPos] = plugin->bandBuffers[band][sampleIdx];
+            if (linearPhase) {
+                ProcessLinearPhaseCrossover(plugin->linearPhase, numBands, leftProcessingGain,
+                                            rightProcessingGain, bands);
+                StageBands(plugin, sampleIdx, bands, processingGain, false);
+            } else if (lr4) {
+                if (crossoverRamping) {
+                    StepLR4Crossover(plugin, crossoverSmoothers);
+                }
+                ProcessLR4Crossover(plugin->lr4Points, plugin->lr4Stages, numBands, leftProcessingGain,
+                                    rightProcessingGain, bands);
+                StageBands(plugin, sampleIdx, bands, processingGain, false);
+            } else if (blockFilters) {
+                for (int line = 0; line < 6; line++) {
+                    bands[line] = spanBands[line][sampleIdx % SMOOTHER_SPAN_SAMPLES];
+                }
+                StageBands(plugin, sampleIdx, bands, processingGain, false);
+            } else {
+                // Apply multiband filtering
+                ProcessBiquadFilter(&plugin->crossoverFilters[0], leftProcessingGain);
+                ProcessBiquadFilter(&plugin->crossoverFilters[1], rightProcessingGain);
+                ProcessBiquadFilter(&plugin->crossoverFilters[2], GetBiquadLowpass(&plugin->crossoverFilters[0]));
+                ProcessBiquadFilter(&plugin->crossoverFilters[3], GetBiquadLowpass(&plugin->crossoverFilters[1]));
+                
+                // Store band outputs  
+                plugin->bandBuffers[0][sampleIdx] = GetBiquadLowpass(&plugin->crossoverFilters[2]) * processingGain;
+                plugin->bandBuffers[1][sampleIdx] = GetBiquadLowpass(&plugin->crossoverFilters[3]) * processingGain;
+                
+                // No mid band in simple mode
+                plugin->bandBuffers[2][sampleIdx] = 0.0f;
+                plugin->bandBuffers[3][sampleIdx] = 0.0f;
+                
+                // Process additional filter stages
+                ProcessBiquadFilter(&plugin->crossoverFilters[4], leftProcessingGain);
+                ProcessBiquadFilter(&plugin->crossoverFilters[5], rightProcessingGain);
+                
+                // Store high frequency bands
+                plugin->bandBuffers[4][sampleIdx] = GetBiquadHighpass(&plugin->crossoverFilters[4]) * processingGain;
+                plugin->bandBuffers[5][sampleIdx] = GetBiquadHighpass(&plugin->crossoverFilters[5]) * processingGain;
             }
             
-            // Store original input in delay buffer
-            plugin->delayBuffers[6][bufferPos] = inputs[0][sampleIdx];
-            plugin->delayBuffers[7][bufferPos] = inputs[rightChannelIdx][sampleIdx];
-            
-            // Advance buffer position
-            plugin->bufferIndex++;
-            if (plugin->bufferIndex >= DELAY_BUFFER_SIZE) {
-                plugin->bufferIndex = 0;
+            // Update delay buffers (lookahead only)
+            if (lookahead) {
+                WriteDelayLines(plugin, inputs, sampleIdx, rightChannelIdx);
             }
         }
         
@@ -204,20 +977,18 @@ void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_
         // ====================================================================
         
         for (int64_t sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
-            // Smooth all parameters
-            float* depthSmoother = (float*)plugin->depthSmoother;
-            float smoothedDepth = (plugin->depth - depthSmoother[0]) * depthSmoother[1] + depthSmoother[0];
-            depthSmoother[0] = smoothedDepth;
+            if (blockFilters && sampleIdx % SMOOTHER_SPAN_SAMPLES == 0) {
+                StageLegacySpan(plugin, &legacyKernels, inputs, rightChannelIdx, sampleIdx, numSamples,
+                                upwardSmoother, spanBands);
+            }
             
-            float* upwardSmoother = (float*)plugin->upwardSmoother;  
-            float smoothedUpward = (plugin->upwardRatio - upwardSmoother[0]) * upwardSmoother[1] + upwardSmoother[0];
-            upwardSmoother[0] = smoothedUpward;
+            // Smooth all parameters
+            float smoothedDepth = AdvanceSmoother(&depthSmoother);
+            float smoothedUpward = AdvanceSmoother(&upwardSmoother);
             plugin->currentGain = smoothedUpward;
             
             // Calculate processing gains
             float processingGain = smoothedDepth * COMPRESSION_SCALING + 1.0f;
-            float upwardGain1 = smoothedUpward * UPWARD_MULT_1 + 1.0f;  
-            float upwardGain2 = smoothedUpward * UPWARD_MULT_2 + 1.0f;
             
             // Get input samples
             float leftInput = inputs[0][sampleIdx] * plugin->currentGain;
@@ -227,40 +998,47 @@ void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_
             // MULTIBAND CROSSOVER FILTERING
             // ================================================================
             
-            // Apply all 6 crossover filters for 3-band separation
-            for (int filterIdx = 0; filterIdx < 6; filterIdx++) {
-                float inputSample = (filterIdx % 2 == 0) ? leftInput : rightInput;
-                ProcessBiquadFilter(&plugin->crossoverFilters[filterIdx], inputSample);
-            }
-            
-            // Extract band outputs (Low, Mid, High for L/R)
-            float lowLeft = GetBiquadLowpass(&plugin->crossoverFilters[0]) * processingGain;
-            float lowRight = GetBiquadLowpass(&plugin->crossoverFilters[1]) * processingGain;
-            float midLeft = GetBiquadHighpass(&plugin->crossoverFilters[2]) * processingGain;
-            float midRight = GetBiquadHighpass(&plugin->crossoverFilters[3]) * processingGain;
-            float highLeft = GetBiquadHighpass(&plugin->crossoverFilters[4]) * processingGain;
-            float highRight = GetBiquadHighpass(&plugin->crossoverFilters[5]) * processingGain;
-            
-            // Store in band buffers
-            plugin->bandBuffers[0][sampleIdx] = lowLeft;
-            plugin->bandBuffers[1][sampleIdx] = lowRight;
-            plugin->bandBuffers[2][sampleIdx] = midLeft;
-            plugin->bandBuffers[3][sampleIdx] = midRight;
-            plugin->bandBuffers[4][sampleIdx] = highLeft;
-            plugin->bandBuffers[5][sampleIdx] = highRight;
-            
-            // Copy to delay buffers with circular indexing
-            int bufferPos = plugin->bufferIndex;
-            for (int band = 0; band < 6; band++) {
-                plugin->delayBuffers[band][bufferPos] = plugin->bandBuffers[band][sampleIdx];
+            if (linearPhase) {
+                ProcessLinearPhaseCrossover(plugin->linearPhase, numBands, leftInput, rightInput, bands);
+                StageBands(plugin, sampleIdx, bands, processingGain, true);
+            } else if (lr4) {
+                if (crossoverRamping) {
+                    StepLR4Crossover(plugin, crossoverSmoothers);
+                }
+                ProcessLR4Crossover(plugin->lr4Points, plugin->lr4Stages, numBands, leftInput, rightInput, bands);
+                StageBands(plugin, sampleIdx, bands, processingGain, true);
+            } else if (blockFilters) {
+                for (int line = 0; line < 6; line++) {
+                    bands[line] = spanBands[line][sampleIdx % SMOOTHER_SPAN_SAMPLES];
+                }
+                StageBands(plugin, sampleIdx, bands, processingGain, true);
+            } else {
+                // Apply all 6 crossover filters for 3-band separation
+                for (int filterIdx = 0; filterIdx < 6; filterIdx++) {
+                    float inputSample = (filterIdx % 2 == 0) ? leftInput : rightInput;
+                    ProcessBiquadFilter(&plugin->crossoverFilters[filterIdx], inputSample);
+                }
+                
+                // Extract band outputs (Low, Mid, High for L/R)
+                float lowLeft = GetBiquadLowpass(&plugin->crossoverFilters[0]) * processingGain;
+                float lowRight = GetBiquadLowpass(&plugin->crossoverFilters[1]) * processingGain;
+                float midLeft = GetBiquadHighpass(&plugin->crossoverFilters[2]) * processingGain;
+                float midRight = GetBiquadHighpass(&plugin->crossoverFilters[3]) * processingGain;
+                float highLeft = GetBiquadHighpass(&plugin->crossoverFilters[4]) * processingGain;
+                float highRight = GetBiquadHighpass(&plugin->crossoverFilters[5]) * processingGain;
+                
+                // Store in band buffers
+                plugin->bandBuffers[0][sampleIdx] = lowLeft;
+                plugin->bandBuffers[1][sampleIdx] = lowRight;
+                plugin->bandBuffers[2][sampleIdx] = midLeft;
+                plugin->bandBuffers[3][sampleIdx] = midRight;
+                plugin->bandBuffers[4][sampleIdx] = highLeft;
+                plugin->bandBuffers[5][sampleIdx] = highRight;
             }
             
-            plugin->delayBuffers[6][bufferPos] = inputs[0][sampleIdx];
-            plugin->delayBuffers[7][bufferPos] = inputs[rightChannelIdx][sampleIdx];
-            
-            plugin->bufferIndex++;
-            if (plugin->bufferIndex >= DELAY_BUFFER_SIZE) {
-                plugin->bufferIndex = 0;
+            // Copy to delay buffers with circular indexing (lookahead only)
+            if (lookahead) {
+                WriteDelayLines(plugin, inputs, sampleIdx, rightChannelIdx);
             }
         }
     }
@@ -269,105 +1047,238 @@ void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_
     // COMPRESSOR PROCESSING & OUTPUT GENERATION  
     // ========================================================================
     
-    // Calculate buffer positions for delay compensation
-    int currentBufferPos = plugin->bufferIndex;
-    int readPos = currentBufferPos - numSamples;
-    if (readPos < 0) readPos += DELAY_BUFFER_SIZE;
+    // The detector reads the current bands from bandBuffers; with lookahead
+    // the mixed bands come from the delay ring, lookaheadSamples behind them
+    int readPos = (int)chunkStart - (int)lookaheadSamples;
+    if (readPos < 0) readPos += plugin->delayRingSize;
     
     plugin->writeIndex = readPos;
     
+    ProcessStagedCompressors(plugin, outputs, numSamples, lookahead, &outputSmoother);
+    plugin->depthSmoother = depthSmoother;
+    plugin->upwardSmoother = upwardSmoother;
+    plugin->outputSmoother = outputSmoother;
+    for (int point = 0; point < numBands - 1; point++) {
+        plugin->crossoverSmoothers[point] = crossoverSmoothers[point];
+    }
+}
+
+// ============================================================================
+// SILENCE DETECTION / SLEEP
+// ============================================================================
+
+/*
+ * An instance sleeps once its silent tail has fully decayed: running it on
+ * more silence would output zeros and leave every bit of state as it is.
+ * That takes
+ *   - crossover state flushed to exactly zero, so the bands are zero too;
+ *   - lookaheadSamples of zero bands since then, so the delay ring only
+ *     holds zeros;
+ *   - peak envelopes decayed to zero and all smoothers settled;
+ *   - compressors at a fixed point: one more silent sample leaves their
+ *     running state unchanged;
+ *   - when oversampling, those gains and zero bands repeated through
+ *     every half-band ring.
+ * While asleep a chunk costs one input scan and the compressor probe. The
+ * first non-zero sample wakes the instance and its chunk is processed from
+ * the unchanged state, so sleeping never changes the output.
+ */
+
+// Digital silence (either sign of zero) on both inputs
+static bool IsSilentChunk(const float* left, const float* right, int64_t numSamples)
+{
+    uint32_t bits = 0;
     for (int64_t sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
-        // ====================================================================
-        // ADVANCED COMPRESSION ALGORITHM (3-BAND)
-        // ====================================================================
-        
-        // Smooth output gain
-        float* outputSmoother = (float*)plugin->outputSmoother;  
-        float smoothedOutput = (plugin->finalGain - outputSmoother[0]) * outputSmoother[1] + outputSmoother[0];
-        outputSmoother[0] = smoothedOutput;
-        plugin->finalGain = smoothedOutput;
-        
-        int readIndex = plugin->writeIndex;
-        
-        // Get band samples from delay buffers
-        float lowLeft = plugin->delayBuffers[0][readIndex];
-        float lowRight = plugin->delayBuffers[1][readIndex];
-        float midLeft = plugin->delayBuffers[2][readIndex];  
-        float midRight = plugin->delayBuffers[3][readIndex];
-        float highLeft = plugin->delayBuffers[4][readIndex];
-        float highRight = plugin->delayBuffers[5][readIndex];
-        
-        // Calculate RMS power for each band
-        float lowPower = lowLeft * lowLeft + lowRight * lowRight + NOISE_FLOOR;
-        float midPower = midLeft * midLeft + midRight * midRight + NOISE_FLOOR;
-        float highPower = highLeft * highLeft + highRight * highRight + NOISE_FLOOR;
-        
-        // ================================================================
-        // COMPRESSION PROCESSING
-        // ================================================================
+        uint32_t leftBits, rightBits;
+        memcpy(&leftBits, &left[sampleIdx], sizeof(leftBits));
+        memcpy(&rightBits, &right[sampleIdx], sizeof(rightBits));
+        bits |= leftBits | rightBits;
+    }
+    return (bits & 0x7fffffffu) == 0;
+}
+
+// An idle LR4 or linear-phase network holds zero state and is skipped
+static bool CrossoverAtRest(const OTTPlugin* plugin)
+{
+    for (int i = 0; i < 6; i++) {
+        if (plugin->crossoverFilters[i].state1 != 0.0f || plugin->crossoverFilters[i].state2 != 0.0f) {
+            return false;
+        }
+    }
+    const int lr4Stages = (plugin->crossoverTopology == OTT_CROSSOVER_LR4) ?
+                          OTT_LR4_STAGE_COUNT((int)plugin->numBands) : 0;
+    for (int stage = 0; stage < lr4Stages; stage++) {
+        for (int lane = 0; lane < 4; lane++) {
+            if (plugin->lr4Stages[stage].ic1eq[lane] != 0.0f || plugin->lr4Stages[stage].ic2eq[lane] != 0.0f) {
+                return false;
+            }
+        }
+    }
+    if (plugin->crossoverTopology == OTT_CROSSOVER_LINEAR_PHASE) {
+        return LinearPhaseCrossoverAtRest(plugin->linearPhase);
+    }
+    return true;
+}
+
+static bool SameCompressorState(const CompressorState* a, const CompressorState* b)
+{
+    return a->rms_smoother == b->rms_smoother &&
+           a->log_envelope == b->log_envelope &&
+           a->gain_reduction == b->gain_reduction &&
+           a->envelope_output == b->envelope_output &&
+           a->processed_envelope == b->processed_envelope &&
+           a->envelope_level == b->envelope_level;
+}
+
+// Runs one silent sample through a copy of the active compressors, at the
+// current precision, backend and output level; gains gets its band gains
+static bool CompressorsAtRest(const OTTPlugin* plugin, float gains[OTT_MAX_BANDS])
+{
+    const int numBands = (int)plugin->numBands;
+    const float silentBands[2 * OTT_MAX_BANDS] = { 0.0f };
+    CompressorState probe[OTT_MAX_BANDS];
+    memcpy(probe, plugin->compressors, numBands * sizeof(CompressorState));
+    
+    BandCompressors compressors;
+    float power[OTT_MAX_BANDS];
+    GetBandPowers(silentBands, numBands, power);
+    LoadBandCompressors(&compressors, probe, plugin->bandOutputGains, plugin->compressorPrecision, numBands);
+    ProcessBandCompressors(&compressors, numBands, power, plugin->outputSmoother.value, gains);
+    StoreBandCompressors(&compressors, numBands);
+    
+    for (int band = 0; band < numBands; band++) {
+        if (!SameCompressorState(&probe[band], &plugin->compressors[band])) return false;
+    }
+    return true;
+}
+
+// Everything but the crossover/delay ring condition, which the chunk loop
+// tracks through restSamples
+static bool TailDecayed(const OTTPlugin* plugin)
+{
+    float gains[OTT_MAX_BANDS];
+    return plugin->peakEnvelopeLeft == 0.0f && plugin->peakEnvelopeRight == 0.0f &&
+           plugin->depthSmoother.settled && plugin->upwardSmoother.settled &&
+           plugin->outputSmoother.settled &&
+           CrossoverSettled(plugin->crossoverSmoothers, (int)plugin->numBands) &&
+           CompressorsAtRest(plugin, gains) &&
+           (!plugin->oversampler ||
+            GainOversamplerAtRest(plugin->oversampler, (int)plugin->numBands, gains, plugin->outputSmoother.value));
+}
+
+bool OTT_IsSleeping(const OTTPlugin* plugin)
+{
+    return plugin->sleeping;
+}
+
+// ============================================================================
+// MAIN AUDIO PROCESSING FUNCTION
+// ============================================================================
+
+void OTT_ProcessAudio(OTTPlugin* plugin, float** inputs, float** outputs, int32_t sampleCount)
+{
+    int64_t numSamples = (int64_t)sampleCount;
+    
+    // Early exit if bypassed
+    if (plugin->bypass) {
+        // Copy input to output when bypassed; a channel processed in place
+        // is left alone, so full in-place bypass touches no memory
+        const bool copyLeft = inputs[0] && outputs[0] && outputs[0] != inputs[0];
+        const bool copyRight = inputs[1] && outputs[1] && outputs[1] != inputs[1];
+        if (!copyLeft && !copyRight) return;
         
-        float lowGainReduction = (float)ProcessCompressorBand(
-            &plugin->compressorLow,
-            lowPower,
-            smoothedOutput,
-            plugin->lowBandGain,
-            ENVELOPE_TIME_CONSTANT
-        );
+        // Both channels are read before either is written, for swapped
+        // or shared buffers
+        for (int i = 0; i < sampleCount; i++) {
+            float left = copyLeft ? inputs[0][i] : 0.0f;
+            float right = copyRight ? inputs[1][i] : 0.0f;
+            if (copyLeft) outputs[0][i] = left;
+            if (copyRight) outputs[1][i] = right;
+        }
+        return;
+    }
+    
+    // ========================================================================
+    // CHANNEL SETUP
+    // ========================================================================
+    
+    // Right channel buffers for this block: the second buffer when the host
+    // passes one, otherwise mono on the first
+    plugin->inputChannelIndex = (plugin->inputChannels == 2 && inputs[1]) ? 1 : 0;
+    plugin->outputChannelIndex = (plugin->outputChannels == 2 && outputs[1]) ? 1 : 0;
+    
+    int64_t rightChannelIdx = plugin->inputChannelIndex;
+    
+    // Parameters only change between blocks
+    SetSmootherTarget(&plugin->depthSmoother, plugin->depth);
+    SetSmootherTarget(&plugin->upwardSmoother, plugin->upwardRatio);
+    SetSmootherTarget(&plugin->outputSmoother, plugin->finalGain);
+    for (uint32_t point = 0; point + 1 < plugin->numBands; point++) {
+        SetSmootherTarget(&plugin->crossoverSmoothers[point], plugin->crossoverTargets[point]);
+    }
+    if (plugin->crossoverTopology == OTT_CROSSOVER_LEGACY) {
+        StepLegacyCrossover(plugin);
+    } else if (plugin->crossoverTopology == OTT_CROSSOVER_LINEAR_PHASE) {
+        StepLinearPhaseCrossover(plugin);
+    }
+    
+    // ========================================================================
+    // CHUNKED PROCESSING
+    // ========================================================================
+    
+    if (numSamples <= 0) return;
+    
+    // Host blocks of any length are split into chunks no longer than the
+    // band buffers; every engine is chunk-size invariant. The delay ring is
+    // sized so a chunk and the lookahead always fit in it together.
+    const int64_t chunkSize = plugin->processingChunkSize;
+    
+    for (int64_t offset = 0; offset < numSamples; offset += chunkSize) {
+        int64_t chunkSamples = numSamples - offset;
+        if (chunkSamples > chunkSize) chunkSamples = chunkSize;
         
-        float midGainReduction = (float)ProcessCompressorBand(
-            &plugin->compressorMid,
-            midPower, 
-            smoothedOutput,
-            plugin->midBandGain,
-            ENVELOPE_TIME_CONSTANT
-        );
+        float* chunkInputs[2] = { inputs[0] + offset, inputs[1] ? inputs[1] + offset : NULL };
+        float* chunkOutputs[2] = { outputs[0] + offset, outputs[1] ? outputs[1] + offset : NULL };
         
-        float highGainReduction = (float)ProcessCompressorBand(
-            &plugin->compressorHigh,
-            highPower,
-            smoothedOutput, 
-            plugin->highBandGain,
-            ENVELOPE_TIME_CONSTANT
-        );
+        // Input is only scanned once the crossover has come to rest; then
+        // the whole chunk's bands are exactly zero
+        const bool silent = (plugin->sleeping || CrossoverAtRest(plugin)) &&
+                            IsSilentChunk(chunkInputs[0], chunkInputs[rightChannelIdx], chunkSamples);
         
-        // ================================================================
-        // OUTPUT MIXING & FINAL GAIN
-        // ================================================================
+        if (plugin->sleeping) {
+            if (silent && TailDecayed(plugin)) {
+                if (plugin->linearPhase) SkipLinearPhaseCrossover(plugin->linearPhase, (uint32_t)chunkSamples);
+                memset(chunkOutputs[0], 0, chunkSamples * sizeof(float));
+                memset(chunkOutputs[plugin->outputChannelIndex], 0, chunkSamples * sizeof(float));
+                continue;
+            }
+            plugin->sleeping = false;
+        }
         
-        // Apply gain reduction to each band
-        lowLeft *= lowGainReduction;
-        lowRight *= lowGainReduction; 
-        midLeft *= midGainReduction;
-        midRight *= midGainReduction;
-        highLeft *= highGainReduction;
-        highRight *= highGainReduction;
+        if (plugin->lookaheadSamples) {
+            PrepareDelayRing(plugin, chunkSamples);
+        }
         
-        // Mix all bands together
-        float finalLeft = (lowLeft + midLeft + highLeft) * plugin->finalGain;
-        float finalRight = (lowRight + midRight + highRight) * plugin->finalGain;
+        if (plugin->engineMode == OTT_ENGINE_FUSED) {
+            ProcessAudioFused(plugin, chunkInputs, chunkOutputs, chunkSamples, rightChannelIdx);
+        } else {
+            ProcessAudioStaged(plugin, chunkInputs, chunkOutputs, chunkSamples, rightChannelIdx);
+        }
         
-        // Write to output buffers
-        outputs[0][sampleIdx] = finalLeft;
-        outputs[plugin->outputChannelIndex][sampleIdx] = finalRight;
+        FlushDenormalState(plugin);
         
-        // Advance read position
-        plugin->writeIndex++;
-        if (plugin->writeIndex >= DELAY_BUFFER_SIZE) {
-            plugin->writeIndex = 0;
+        // Zero bands in a row, saturating once they cover the lookahead
+        if (!silent) {
+            plugin->restSamples = 0;
+        } else if (plugin->restSamples < plugin->lookaheadSamples) {
+            plugin->restSamples += (uint32_t)chunkSamples;
         }
+        plugin->sleeping = silent && plugin->restSamples >= plugin->lookaheadSamples && TailDecayed(plugin);
     }
     
     // ========================================================================
     // UPDATE COMPRESSOR STATES (for UI display)
     // ========================================================================
     
-    // Store final compressor states for metering/display
-    plugin->compressorStates[0] = (float)plugin->compressorLow.envelope_output * plugin->lowBandGain;
-    plugin->compressorStates[1] = (float)plugin->compressorMid.envelope_output * plugin->midBandGain;
-    plugin->compressorStates[2] = (float)plugin->compressorHigh.envelope_output * plugin->highBandGain;
-    
-    // Store envelope followers for UI meters
-    plugin->compressorStates[3] = (float)plugin->compressorLow.rms_smoother;
-    plugin->compressorStates[4] = (float)plugin->compressorMid.rms_smoother;
-    plugin->compressorStates[5] = (float)plugin->compressorHigh.rms_smoother;
+    StoreMeterStates(plugin);
 }
@@ -0,0 +1,336 @@
+/**
+ * OTT Crossover Response
+ * Magnitude and phase of the crossover bands over a frequency grid
+ */
+
+#include "ott_plugin.h"
+#include "ott_kernels.h"
+
+// Frequencies between exact cos/sin seeds of the grid recurrence
+#define RESPONSE_RESEED 64
+
+// ============================================================================
+// SECTION TRANSFER FUNCTIONS
+// ============================================================================
+
+/*
+ * The legacy sections and the TPT SVF run the same recurrence on
+ * s = (s1, s2), ProcessBiquadFilter's state1 / state2 or the SVF's
+ * ic1eq / ic2eq:
+ *   v1 = a1 s1 + a2 (x - s2)
+ *   v2 = s2 + a2 s1 + a3 (x - s2)
+ *   s' = (2 v1 - s1, 2 v2 - s2)
+ * with lowpass v2, highpass x - k v1 - v2 and allpass x - 2k v1; a legacy
+ * section's coeff_a1 / coeff_a2 / coeff_b2 / b1 are a1 / a2 / a3 / k. The
+ * transfer functions are taken from that recurrence with the coefficients
+ * as they are, so they describe what the engines run whatever
+ * CalculateBiquadCoefficients put there. Every output shares the
+ * denominator: H(z) = (n0 + n1 z^-1 + n2 z^-2) / (1 + d1 z^-1 + d2 z^-2).
+ */
+typedef struct {
+    float d1, d2;
+    float lowpass[3];
+    float highpass[3];
+    float allpass[3];
+} SectionTransfer;
+
+static void BuildSectionTransfer(SectionTransfer* transfer, double a1, double a2, double a3, double k)
+{
+    // s' = A s + B x
+    const double A00 = 2.0 * a1 - 1.0, A01 = -2.0 * a2;
+    const double A10 = 2.0 * a2, A11 = 1.0 - 2.0 * a3;
+    const double B0 = 2.0 * a2, B1 = 2.0 * a3;
+    const double trace = A00 + A11;
+    const double det = A00 * A11 - A01 * A10;
+    
+    // Tap c1 s1 + c2 s2 + d x is C adj(zI - A) B / det(zI - A) + d
+    const double outputs[2][3] = { { a1, -a2, a2 },         // v1
+                                   { a2, 1.0 - a3, a3 } };  // v2
+    double numerator[2][3];
+    for (int tap = 0; tap < 2; tap++) {
+        const double c1 = outputs[tap][0], c2 = outputs[tap][1], d = outputs[tap][2];
+        numerator[tap][0] = d;
+        numerator[tap][1] = c1 * B0 + c2 * B1 - d * trace;
+        numerator[tap][2] = c1 * (A01 * B1 - A11 * B0) + c2 * (A10 * B0 - A00 * B1) + d * det;
+    }
+    
+    const double denominator[3] = { 1.0, -trace, det };
+    transfer->d1 = (float)denominator[1];
+    transfer->d2 = (float)denominator[2];
+    for (int i = 0; i < 3; i++) {
+        transfer->lowpass[i] = (float)numerator[1][i];
+        transfer->highpass[i] = (float)(denominator[i] - k * numerator[0][i] - numerator[1][i]);
+        transfer->allpass[i] = (float)(denominator[i] - 2.0 * k * numerator[0][i]);
+    }
+}
+
+// Lowpass magnitude of one legacy section at frequency, a single point of
+// what OTT_GetCrossoverResponse evaluates in bulk
+float CalculateFilterResponse(BiquadFilter* filter, float frequency, float sampleRate)
+{
+    SectionTransfer transfer;
+    BuildSectionTransfer(&transfer, filter->coeff_a1, filter->coeff_a2, filter->coeff_b2, filter->b1);
+    
+    const double omega = 2.0 * OTT_PI * frequency / sampleRate;
+    const double c1 = cos(omega), s1 = -sin(omega);
+    const double c2 = cos(2.0 * omega), s2 = -sin(2.0 * omega);
+    
+    double numRe = transfer.lowpass[0] + transfer.lowpass[1] * c1 + transfer.lowpass[2] * c2;
+    double numIm = transfer.lowpass[1] * s1 + transfer.lowpass[2] * s2;
+    double denRe = 1.0 + transfer.d1 * c1 + transfer.d2 * c2;
+    double denIm = transfer.d1 * s1 + transfer.d2 * s2;
+    return (float)sqrt((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+}
+
+// ============================================================================
+// COMPLEX LANES
+// ============================================================================
+
+// Four complex values, one frequency per lane
+typedef struct {
+    OTTVec4 re;
+    OTTVec4 im;
+} ResponseVec;
+
+static inline ResponseVec ResponseMul(ResponseVec a, ResponseVec b)
+{
+    ResponseVec product = { Vec4Sub(Vec4Mul(a.re, b.re), Vec4Mul(a.im, b.im)),
+                            Vec4Add(Vec4Mul(a.re, b.im), Vec4Mul(a.im, b.re)) };
+    return product;
+}
+
+static inline ResponseVec ResponseAdd(ResponseVec a, ResponseVec b)
+{
+    ResponseVec sum = { Vec4Add(a.re, b.re), Vec4Add(a.im, b.im) };
+    return sum;
+}
+
+// n0 + n1 z^-1 + n2 z^-2
+static inline ResponseVec EvaluatePolynomial(const float n[3], ResponseVec z1, ResponseVec z2)
+{
+    ResponseVec value = { Vec4Add(Vec4Splat(n[0]), Vec4Add(Vec4Mul(Vec4Splat(n[1]), z1.re),
+                                                           Vec4Mul(Vec4Splat(n[2]), z2.re))),
+                          Vec4Add(Vec4Mul(Vec4Splat(n[1]), z1.im), Vec4Mul(Vec4Splat(n[2]), z2.im)) };
+    return value;
+}
+
+typedef struct {
+    ResponseVec lowpass;
+    ResponseVec highpass;
+    ResponseVec allpass;
+} SectionResponse;
+
+// All three outputs of one section, with one division for the shared
+// denominator
+static SectionResponse EvaluateSection(const SectionTransfer* transfer, ResponseVec z1, ResponseVec z2)
+{
+    const float denominator[3] = { 1.0f, transfer->d1, transfer->d2 };
+    ResponseVec den = EvaluatePolynomial(denominator, z1, z2);
+    OTTVec4 scale = Vec4Div(Vec4Splat(1.0f), Vec4Add(Vec4Mul(den.re, den.re), Vec4Mul(den.im, den.im)));
+    ResponseVec inverse = { Vec4Mul(den.re, scale), Vec4Sub(Vec4Zero(), Vec4Mul(den.im, scale)) };
+    
+    SectionResponse response = { ResponseMul(EvaluatePolynomial(transfer->lowpass, z1, z2), inverse),
+                                 ResponseMul(EvaluatePolynomial(transfer->highpass, z1, z2), inverse),
+                                 ResponseMul(EvaluatePolynomial(transfer->allpass, z1, z2), inverse) };
+    return response;
+}
+
+// ============================================================================
+// BAND NETWORKS
+// ============================================================================
+
+// Left channel of the legacy split, as the engines wire it: filters 0 / 2 /
+// 4 on the input in advanced mode, 2 cascaded after 0 and no mid band in
+// simple mode
+static void EvaluateLegacyBands(const SectionTransfer* sections, bool advanced, ResponseVec z1, ResponseVec z2,
+                                ResponseVec* bands)
+{
+    SectionResponse low = EvaluateSection(&sections[0], z1, z2);
+    SectionResponse mid = EvaluateSection(&sections[1], z1, z2);
+    SectionResponse high = EvaluateSection(&sections[2], z1, z2);
+    
+    if (advanced) {
+        bands[0] = low.lowpass;
+        bands[1] = mid.highpass;
+    } else {
+        bands[0] = ResponseMul(low.lowpass, mid.lowpass);
+        bands[1].re = Vec4Zero();
+        bands[1].im = Vec4Zero();
+    }
+    bands[2] = high.highpass;
+}
+
+// ProcessLR4Crossover's network: band b is the highpass pairs below it,
+// its own lowpass pair and one allpass for every point above it
+static void EvaluateLR4Bands(const SectionTransfer* sections, int numBands, ResponseVec z1, ResponseVec z2,
+                             ResponseVec* bands)
+{
+    ResponseVec rest = { Vec4Splat(1.0f), Vec4Zero() };
+    for (int point = 0; point < numBands - 1; point++) {
+        SectionResponse section = EvaluateSection(&sections[point], z1, z2);
+        for (int band = 0; band < point; band++) {
+            bands[band] = ResponseMul(bands[band], section.allpass);
+        }
+        bands[point] = ResponseMul(rest, ResponseMul(section.lowpass, section.lowpass));
+        rest = ResponseMul(rest, ResponseMul(section.highpass, section.highpass));
+    }
+    bands[numBands - 1] = rest;
+}
+
+// ============================================================================
+// RESPONSE EVALUATION
+// ============================================================================
+
+// atan2(y, x) per lane, folded into the first octant and run through
+// Abramowitz & Stegun 4.4.49 (within 1e-5 rad); 0 where both are 0
+static inline OTTVec4 ResponseAtan2(OTTVec4 y, OTTVec4 x)
+{
+    const OTTVec4 ax = Vec4Abs(x), ay = Vec4Abs(y);
+    const OTTMask4 steep = Vec4CmpGt(ay, ax);
+    const OTTVec4 a = Vec4Div(Vec4Select(steep, ax, ay), Vec4Max(Vec4Select(steep, ay, ax), Vec4Splat(FLT_MIN)));
+    const OTTVec4 s = Vec4Mul(a, a);
+    
+    OTTVec4 angle = Vec4Add(Vec4Splat(-0.0851330f), Vec4Mul(s, Vec4Splat(0.0208351f)));
+    angle = Vec4Add(Vec4Splat(0.1801410f), Vec4Mul(s, angle));
+    angle = Vec4Add(Vec4Splat(-0.3302995f), Vec4Mul(s, angle));
+    angle = Vec4Mul(a, Vec4Add(Vec4Splat(0.9998660f), Vec4Mul(s, angle)));
+    
+    angle = Vec4Select(steep, Vec4Sub(Vec4Splat((float)(OTT_PI / 2.0)), angle), angle);
+    angle = Vec4Select(Vec4CmpGt(Vec4Zero(), x), Vec4Sub(Vec4Splat((float)OTT_PI), angle), angle);
+    return Vec4Select(Vec4CmpGt(Vec4Zero(), y), Vec4Sub(Vec4Zero(), angle), angle);
+}
+
+static inline void StoreResponseLanes(float* row, int32_t index, int32_t count, OTTVec4 value)
+{
+    float lanes[4];
+    Vec4Store(lanes, value);
+    for (int lane = 0; lane < 4 && index + lane < count; lane++) {
+        row[index + lane] = lanes[lane];
+    }
+}
+
+// The linear-phase bands: amplitudes of neighbouring lowpasses subtracted,
+// and the delay as phase
+static void EvaluateLinearPhaseResponse(const OTTPlugin* plugin, int numBands, float startHz, float stepHz,
+                                        int32_t count, float* magnitude, float* phase)
+{
+    const int points = numBands - 1;
+    for (int point = 0; point < points; point++) {
+        LinearPhaseLowpassAmplitude(plugin->linearPhase, plugin->crossoverFrequencies[point], plugin->sampleRate,
+                                    startHz, stepHz, count, magnitude + (size_t)point * count);
+    }
+    
+    float* sum = magnitude + (size_t)numBands * count;
+    for (int32_t i = 0; i < count; i++) {
+        double delay = -2.0 * OTT_PI * (startHz + (double)i * stepHz) / plugin->sampleRate *
+                       OTT_LINEAR_PHASE_LATENCY;
+        float delayPhase = (float)remainder(delay, 2.0 * OTT_PI);
+        
+        float lower = 0.0f;
+        for (int band = 0; band < numBands; band++) {
+            float* row = magnitude + (size_t)band * count;
+            float lowpass = (band < points) ? row[i] : 1.0f;
+            float amplitude = lowpass - lower;
+            lower = lowpass;
+            
+            if (phase) {
+                float flip = (amplitude < 0.0f) ? ((delayPhase > 0.0f) ? -(float)OTT_PI : (float)OTT_PI) : 0.0f;
+                phase[(size_t)band * count + i] = delayPhase + flip;
+            }
+            row[i] = fabsf(amplitude);
+        }
+        
+        sum[i] = 1.0f;
+        if (phase) phase[(size_t)numBands * count + i] = delayPhase;
+    }
+}
+
+/*
+ * Response of the crossover as it is tuned right now, left channel, at the
+ * count frequencies startHz + i * stepHz. Returns the band count B and
+ * fills B + 1 rows of count values: row b is band b, row B the sum of all
+ * bands. magnitude is linear gain; phase, which may be NULL, is in radians
+ * in [-pi, pi], within 1e-5. The gain stages around the crossover are not
+ * included.
+ *
+ * Four frequencies run per vector. e^-jw advances along the grid by one
+ * complex multiply per step and is reseeded from cos/sin every
+ * RESPONSE_RESEED frequencies, so the IIR networks cost a few dozen vector
+ * operations per four points and section. The linear-phase kernels are
+ * far dearer (see LinearPhaseLowpassAmplitude). Like the setters, this
+ * reads plugin state unsynchronized: call it from the thread that sets
+ * the parameters.
+ */
+int32_t OTT_GetCrossoverResponse(const OTTPlugin* plugin, float startHz, float stepHz, int32_t count,
+                                 float* magnitude, float* phase)
+{
+    if (count <= 0 || !magnitude) return 0;
+    
+    const OTTCrossoverTopology topology = plugin->crossoverTopology;
+    const bool linearPhase = topology == OTT_CROSSOVER_LINEAR_PHASE;
+    const bool lr4 = !linearPhase && (plugin->numBands != NUM_FREQUENCY_BANDS || topology == OTT_CROSSOVER_LR4);
+    const int numBands = (int)plugin->numBands;
+    
+    if (linearPhase) {
+        EvaluateLinearPhaseResponse(plugin, numBands, startHz, stepHz, count, magnitude, phase);
+        return numBands;
+    }
+    
+    SectionTransfer sections[OTT_MAX_CROSSOVERS];
+    if (lr4) {
+        for (int point = 0; point < numBands - 1; point++) {
+            const SVFCoefficients* c = &plugin->lr4Points[point];
+            BuildSectionTransfer(&sections[point], c->a1, c->a2, c->a3, c->k);
+        }
+    } else {
+        for (int section = 0; section < 3; section++) {
+            const BiquadFilter* filter = &plugin->crossoverFilters[2 * section];
+            BuildSectionTransfer(&sections[section], filter->coeff_a1, filter->coeff_a2, filter->coeff_b2,
+                                 filter->b1);
+        }
+    }
+    
+    const double omegaStart = 2.0 * OTT_PI * startHz / plugin->sampleRate;
+    const double omegaStep = 2.0 * OTT_PI * stepHz / plugin->sampleRate;
+    const ResponseVec rotate = { Vec4Splat((float)cos(4.0 * omegaStep)), Vec4Splat((float)-sin(4.0 * omegaStep)) };
+    ResponseVec z1;
+    
+    for (int32_t index = 0; index < count; index += 4) {
+        if (index % RESPONSE_RESEED == 0) {
+            float seedRe[4], seedIm[4];
+            for (int lane = 0; lane < 4; lane++) {
+                double omega = omegaStart + (index + lane) * omegaStep;
+                seedRe[lane] = (float)cos(omega);
+                seedIm[lane] = (float)-sin(omega);
+            }
+            z1.re = Vec4Load(seedRe);
+            z1.im = Vec4Load(seedIm);
+        } else {
+            z1 = ResponseMul(z1, rotate);
+        }
+        const ResponseVec z2 = ResponseMul(z1, z1);
+        
+        ResponseVec bands[OTT_MAX_BANDS + 1];
+        if (lr4) {
+            EvaluateLR4Bands(sections, numBands, z1, z2, bands);
+        } else {
+            EvaluateLegacyBands(sections, plugin->advancedMode, z1, z2, bands);
+        }
+        
+        ResponseVec sum = bands[0];
+        for (int band = 1; band < numBands; band++) {
+            sum = ResponseAdd(sum, bands[band]);
+        }
+        bands[numBands] = sum;
+        
+        for (int row = 0; row <= numBands; row++) {
+            OTTVec4 power = Vec4Add(Vec4Mul(bands[row].re, bands[row].re), Vec4Mul(bands[row].im, bands[row].im));
+            StoreResponseLanes(magnitude + (size_t)row * count, index, count, Vec4Sqrt(power));
+            if (phase) {
+                OTTVec4 angle = ResponseAtan2(bands[row].im, bands[row].re);
+                StoreResponseLanes(phase + (size_t)row * count, index, count, angle);
+            }
+        }
+    }
+    return numBands;
+}
@@ -0,0 +1,183 @@
+#ifndef OTT_SIMD_H
+#define OTT_SIMD_H
+
+/**
+ * OTT SIMD Helpers
+ * Thin 4-lane float vector wrapper used by the lane-parallel DSP kernels.
+ * Maps to SSE2 on x86 and to plain arrays everywhere else; define
+ * OTT_DISABLE_SIMD to force the portable version.
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+#if defined(__SSE2__) && !defined(OTT_DISABLE_SIMD)
+#define OTT_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// ============================================================================
+// 4-LANE FLOAT VECTOR
+// ============================================================================
+
+#ifdef OTT_SIMD_SSE2
+
+typedef __m128 OTTVec4;
+
+static inline OTTVec4 Vec4Zero(void)                       { return _mm_setzero_ps(); }
+static inline OTTVec4 Vec4Splat(float x)                   { return _mm_set1_ps(x); }
+static inline OTTVec4 Vec4Set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+static inline OTTVec4 Vec4Load(const float* p)             { return _mm_loadu_ps(p); }
+static inline void    Vec4Store(float* p, OTTVec4 v)       { _mm_storeu_ps(p, v); }
+
+static inline OTTVec4 Vec4Add(OTTVec4 a, OTTVec4 b)        { return _mm_add_ps(a, b); }
+static inline OTTVec4 Vec4Sub(OTTVec4 a, OTTVec4 b)        { return _mm_sub_ps(a, b); }
+static inline OTTVec4 Vec4Mul(OTTVec4 a, OTTVec4 b)        { return _mm_mul_ps(a, b); }
+static inline OTTVec4 Vec4Div(OTTVec4 a, OTTVec4 b)        { return _mm_div_ps(a, b); }
+
+static inline float   Vec4Lane0(OTTVec4 v)                 { return _mm_cvtss_f32(v); }
+
+// Lane shuffles: {a0, a1, b0, b1}, {a2, a3, b2, b3}, {a2, a3, b0, b1} and
+// {a0, a1, b2, b3}
+static inline OTTVec4 Vec4CombineLow(OTTVec4 a, OTTVec4 b)      { return _mm_movelh_ps(a, b); }
+static inline OTTVec4 Vec4CombineHigh(OTTVec4 a, OTTVec4 b)     { return _mm_movehl_ps(b, a); }
+static inline OTTVec4 Vec4CombineHighLow(OTTVec4 a, OTTVec4 b)  { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 2)); }
+static inline OTTVec4 Vec4CombineLowHigh(OTTVec4 a, OTTVec4 b)  { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 2, 1, 0)); }
+
+// Bit i set when !(a[i] < b[i]); unordered lanes (NaN) count as set
+static inline int     Vec4MaskNotLess(OTTVec4 a, OTTVec4 b) { return _mm_movemask_ps(_mm_cmpnlt_ps(a, b)); }
+
+static inline OTTVec4 Vec4Sqrt(OTTVec4 a)                  { return _mm_sqrt_ps(a); }
+static inline OTTVec4 Vec4Abs(OTTVec4 a)                   { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+// a > b ? a : b per lane, so a NaN in a yields b
+static inline OTTVec4 Vec4Max(OTTVec4 a, OTTVec4 b)        { return _mm_max_ps(a, b); }
+
+// Lane masks: all-ones where the comparison holds. Ordered compares are
+// false for NaN lanes, like the scalar operators.
+typedef __m128 OTTMask4;
+
+static inline OTTMask4 Vec4CmpLe(OTTVec4 a, OTTVec4 b)     { return _mm_cmple_ps(a, b); }
+static inline OTTMask4 Vec4CmpGe(OTTVec4 a, OTTVec4 b)     { return _mm_cmpge_ps(a, b); }
+static inline OTTMask4 Vec4CmpGt(OTTVec4 a, OTTVec4 b)     { return _mm_cmpgt_ps(a, b); }
+static inline OTTMask4 Vec4CmpEq(OTTVec4 a, OTTVec4 b)     { return _mm_cmpeq_ps(a, b); }
+static inline OTTMask4 Vec4CmpNaN(OTTVec4 a)               { return _mm_cmpunord_ps(a, a); }
+
+static inline OTTMask4 Mask4And(OTTMask4 a, OTTMask4 b)    { return _mm_and_ps(a, b); }
+static inline OTTMask4 Mask4Or(OTTMask4 a, OTTMask4 b)     { return _mm_or_ps(a, b); }
+static inline OTTMask4 Mask4AndNot(OTTMask4 a, OTTMask4 b) { return _mm_andnot_ps(b, a); }   // a & ~b
+static inline int      Mask4Bits(OTTMask4 m)               { return _mm_movemask_ps(m); }
+
+// mask ? a : b per lane
+static inline OTTVec4 Vec4Select(OTTMask4 m, OTTVec4 a, OTTVec4 b)
+{
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+#else
+
+typedef struct { float v[4]; } OTTVec4;
+
+static inline OTTVec4 Vec4Zero(void)                       { OTTVec4 r = {{0.0f, 0.0f, 0.0f, 0.0f}}; return r; }
+static inline OTTVec4 Vec4Splat(float x)                   { OTTVec4 r = {{x, x, x, x}}; return r; }
+static inline OTTVec4 Vec4Set(float a, float b, float c, float d) { OTTVec4 r = {{a, b, c, d}}; return r; }
+static inline OTTVec4 Vec4Load(const float* p)             { OTTVec4 r = {{p[0], p[1], p[2], p[3]}}; return r; }
+static inline void    Vec4Store(float* p, OTTVec4 v)       { for (int i = 0; i < 4; i++) p[i] = v.v[i]; }
+
+static inline OTTVec4 Vec4Add(OTTVec4 a, OTTVec4 b)        { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+static inline OTTVec4 Vec4Sub(OTTVec4 a, OTTVec4 b)        { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+static inline OTTVec4 Vec4Mul(OTTVec4 a, OTTVec4 b)        { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+static inline OTTVec4 Vec4Div(OTTVec4 a, OTTVec4 b)        { for (int i = 0; i < 4; i++) a.v[i] /= b.v[i]; return a; }
+
+static inline float   Vec4Lane0(OTTVec4 v)                 { return v.v[0]; }
+
+static inline OTTVec4 Vec4CombineLow(OTTVec4 a, OTTVec4 b)      { OTTVec4 r = {{a.v[0], a.v[1], b.v[0], b.v[1]}}; return r; }
+static inline OTTVec4 Vec4CombineHigh(OTTVec4 a, OTTVec4 b)     { OTTVec4 r = {{a.v[2], a.v[3], b.v[2], b.v[3]}}; return r; }
+static inline OTTVec4 Vec4CombineHighLow(OTTVec4 a, OTTVec4 b)  { OTTVec4 r = {{a.v[2], a.v[3], b.v[0], b.v[1]}}; return r; }
+static inline OTTVec4 Vec4CombineLowHigh(OTTVec4 a, OTTVec4 b)  { OTTVec4 r = {{a.v[0], a.v[1], b.v[2], b.v[3]}}; return r; }
+
+static inline int     Vec4MaskNotLess(OTTVec4 a, OTTVec4 b)
+{
+    int mask = 0;
+    for (int i = 0; i < 4; i++) mask |= !(a.v[i] < b.v[i]) << i;
+    return mask;
+}
+
+static inline OTTVec4 Vec4Sqrt(OTTVec4 a)                  { for (int i = 0; i < 4; i++) a.v[i] = sqrtf(a.v[i]); return a; }
+static inline OTTVec4 Vec4Abs(OTTVec4 a)                   { for (int i = 0; i < 4; i++) a.v[i] = fabsf(a.v[i]); return a; }
+static inline OTTVec4 Vec4Max(OTTVec4 a, OTTVec4 b)        { for (int i = 0; i < 4; i++) a.v[i] = (a.v[i] > b.v[i]) ? a.v[i] : b.v[i]; return a; }
+
+typedef struct { int m[4]; } OTTMask4;
+
+#define OTT_MASK4_COMPARE(name, expr) \
+    static inline OTTMask4 name(OTTVec4 a, OTTVec4 b) \
+    { OTTMask4 r; for (int i = 0; i < 4; i++) { float x = a.v[i], y = b.v[i]; r.m[i] = (expr); } return r; }
+OTT_MASK4_COMPARE(Vec4CmpLe, x <= y)
+OTT_MASK4_COMPARE(Vec4CmpGe, x >= y)
+OTT_MASK4_COMPARE(Vec4CmpGt, x > y)
+OTT_MASK4_COMPARE(Vec4CmpEq, x == y)
+#undef OTT_MASK4_COMPARE
+
+static inline OTTMask4 Vec4CmpNaN(OTTVec4 a)               { OTTMask4 r; for (int i = 0; i < 4; i++) r.m[i] = a.v[i] != a.v[i]; return r; }
+
+static inline OTTMask4 Mask4And(OTTMask4 a, OTTMask4 b)    { for (int i = 0; i < 4; i++) a.m[i] = a.m[i] && b.m[i]; return a; }
+static inline OTTMask4 Mask4Or(OTTMask4 a, OTTMask4 b)     { for (int i = 0; i < 4; i++) a.m[i] = a.m[i] || b.m[i]; return a; }
+static inline OTTMask4 Mask4AndNot(OTTMask4 a, OTTMask4 b) { for (int i = 0; i < 4; i++) a.m[i] = a.m[i] && !b.m[i]; return a; }
+static inline int      Mask4Bits(OTTMask4 m)               { return m.m[0] | m.m[1] << 1 | m.m[2] << 2 | m.m[3] << 3; }
+
+static inline OTTVec4 Vec4Select(OTTMask4 m, OTTVec4 a, OTTVec4 b)
+{
+    for (int i = 0; i < 4; i++) a.v[i] = m.m[i] ? a.v[i] : b.v[i];
+    return a;
+}
+
+#endif
+
+// ============================================================================
+// FLOATING-POINT ENVIRONMENT
+// ============================================================================
+
+/*
+ * Flush-to-zero for the calling thread: subnormal results and operands are
+ * treated as zero instead of taking the slow microcoded path. x86 sets FTZ
+ * and DAZ in MXCSR (this covers scalar float and double math too), AArch64
+ * sets FPCR.FZ. Elsewhere these are no-ops and the engines' block-rate
+ * state flush is the only protection.
+ */
+#if (defined(__SSE__) || defined(__x86_64__)) && !defined(OTT_DISABLE_FTZ)
+#include <xmmintrin.h>
+
+typedef uint32_t OTTFloatEnv;
+
+static inline OTTFloatEnv EnableFlushToZero(void)
+{
+    OTTFloatEnv saved = _mm_getcsr();
+    _mm_setcsr(saved | 0x8040u);        // FTZ (bit 15) | DAZ (bit 6)
+    return saved;
+}
+
+static inline void RestoreFloatEnv(OTTFloatEnv saved)  { _mm_setcsr(saved); }
+
+#elif defined(__aarch64__) && !defined(OTT_DISABLE_FTZ)
+
+typedef uint64_t OTTFloatEnv;
+
+static inline OTTFloatEnv EnableFlushToZero(void)
+{
+    OTTFloatEnv saved;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(saved));
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(saved | (1ull << 24)));    // FZ
+    return saved;
+}
+
+static inline void RestoreFloatEnv(OTTFloatEnv saved)  { __asm__ __volatile__("msr fpcr, %0" : : "r"(saved)); }
+
+#else
+
+typedef uint32_t OTTFloatEnv;
+
+static inline OTTFloatEnv EnableFlushToZero(void)      { return 0; }
+static inline void RestoreFloatEnv(OTTFloatEnv saved)  { (void)saved; }
+
+#endif
+
+#endif // OTT_SIMD_H
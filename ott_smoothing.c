@@ -0,0 +1,74 @@
+#include "ott_plugin.h"
+#include "ott_kernels.h"
+
+// ============================================================================
+// SMOOTHER SETUP
+// ============================================================================
+
+void InitializeSmoother(OTTSmoother* smoother, float value, float coeff)
+{
+    smoother->value = value;
+    smoother->coeff = coeff;
+    smoother->target = value;
+    smoother->step = 0.0f;
+    smoother->rampSamples = 0;
+    smoother->rampRemaining = 0;
+    smoother->shape = OTT_SMOOTHER_EXPONENTIAL;
+    smoother->selfTargeting = false;
+    smoother->settled = true;
+}
+
+// Switch to linear ramps of rampSamples samples; 0 goes back to the
+// one-pole. A ramp in progress restarts from the current value.
+void SetSmootherLinearRamp(OTTSmoother* smoother, int32_t rampSamples)
+{
+    smoother->shape = (rampSamples > 0) ? OTT_SMOOTHER_LINEAR : OTT_SMOOTHER_EXPONENTIAL;
+    smoother->rampSamples = rampSamples;
+    
+    float target = smoother->target;
+    smoother->target = smoother->value;
+    smoother->settled = true;
+    SetSmootherTarget(smoother, target);
+}
+
+// Called once per block with the parameter's current value. An unchanged
+// target keeps the running ramp (or the settled state) as it is.
+void SetSmootherTarget(OTTSmoother* smoother, float target)
+{
+    if (target == smoother->target) return;
+    
+    smoother->target = target;
+    smoother->settled = false;
+    
+    if (smoother->shape == OTT_SMOOTHER_LINEAR) {
+        smoother->step = (target - smoother->value) / (float)smoother->rampSamples;
+        smoother->rampRemaining = smoother->rampSamples;
+    }
+}
+
+// Finish any running ramp at once
+void SnapSmoother(OTTSmoother* smoother)
+{
+    smoother->value = smoother->target;
+    smoother->rampRemaining = 0;
+    smoother->settled = true;
+}
+
+// ============================================================================
+// BLOCK RAMPS
+// ============================================================================
+
+// Write the next numSamples values into ramp; once the smoother settles
+// the rest of the span is its constant value
+void RenderSmootherRamp(OTTSmoother* smoother, float* ramp, int64_t numSamples)
+{
+    int64_t sampleIdx = 0;
+    
+    for (; sampleIdx < numSamples && !smoother->settled; sampleIdx++) {
+        ramp[sampleIdx] = AdvanceSmoother(smoother);
+    }
+    
+    for (; sampleIdx < numSamples; sampleIdx++) {
+        ramp[sampleIdx] = smoother->value;
+    }
+}
@@ -0,0 +1,150 @@
+/**
+ * OTT Block Kernel Test
+ * The block-parallel legacy crossover must track the serial one
+ *
+ * The legacy sections' coefficients are unstable as decoded, so the
+ * sections here get stable state-variable coefficients for the same
+ * recurrence (g = tan(pi f / fs), k = sqrt(2)): the block kernel's
+ * look-ahead is then compared on signals that stay bounded, and rounding
+ * differences can't be hidden or blown up by the filter itself.
+ */
+
+#include "ott_plugin.h"
+#include "ott_kernels.h"
+#include <math.h>
+#include <stdio.h>
+
+// Largest band difference relative to the serial bands' peak. The block
+// kernel reassociates the recurrence, so it only matches to float rounding
+#define BLOCK_MAX_ERROR         1e-5
+
+#define TEST_SAMPLES            16384
+
+// ============================================================================
+// STABLE SECTIONS
+// ============================================================================
+
+// A lowpass/highpass state-variable section at frequency, written into the
+// BiquadFilter recurrence (see ProcessBiquadFilter)
+static void SetStableSection(BiquadFilter* filter, float frequency, float sampleRate)
+{
+    InitializeBiquadFilter(filter);
+    double g = CrossoverPrewarp(frequency, sampleRate);
+    double k = sqrt(2.0);
+    double a1 = 1.0 / (1.0 + g * (g + k));
+    filter->b0 = 1.0f;
+    filter->b1 = (float)k;
+    filter->coeff_a1 = (float)a1;
+    filter->coeff_a2 = (float)(a1 * g);
+    filter->coeff_b2 = (float)(a1 * g * g);
+}
+
+static void SetStableCrossover(BiquadFilter* filters, float lowMid, float midHigh, float sampleRate)
+{
+    for (int i = 0; i < 6; i++) {
+        SetStableSection(&filters[i], (i < 4) ? lowMid : midHigh, sampleRate);
+    }
+}
+
+// ============================================================================
+// SERIAL REFERENCE
+// ============================================================================
+
+// ProcessLegacyCrossoverBlock one sample at a time through ProcessBiquadFilter
+static void ProcessLegacyCrossoverSerial(BiquadFilter* filters, const float* left, const float* right,
+                                         int64_t numSamples, bool advanced, float* const bands[6])
+{
+    for (int64_t i = 0; i < numSamples; i++) {
+        bands[0][i] = ProcessBiquadFilter(&filters[0], left[i]);
+        bands[1][i] = ProcessBiquadFilter(&filters[1], right[i]);
+        if (advanced) {
+            ProcessBiquadFilter(&filters[2], left[i]);
+            ProcessBiquadFilter(&filters[3], right[i]);
+            bands[2][i] = GetBiquadHighpass(&filters[2]);
+            bands[3][i] = GetBiquadHighpass(&filters[3]);
+        } else {
+            bands[0][i] = ProcessBiquadFilter(&filters[2], bands[0][i]);
+            bands[1][i] = ProcessBiquadFilter(&filters[3], bands[1][i]);
+        }
+        ProcessBiquadFilter(&filters[4], left[i]);
+        ProcessBiquadFilter(&filters[5], right[i]);
+        bands[4][i] = GetBiquadHighpass(&filters[4]);
+        bands[5][i] = GetBiquadHighpass(&filters[5]);
+    }
+}
+
+/*
+ * Largest difference between the block and serial crossovers over
+ * TEST_SAMPLES of noise plus a low tone, fed in chunks of chunkSamples
+ * with the kernels rebuilt per chunk as the engines do, relative to the
+ * serial bands' peak. Filter state carries across chunks in both.
+ */
+static double MeasureBlockError(float sampleRate, int64_t chunkSamples, bool advanced)
+{
+    static float left[TEST_SAMPLES], right[TEST_SAMPLES];
+    static float serialBands[6][TEST_SAMPLES], blockBands[6][TEST_SAMPLES];
+    
+    uint32_t seed = 1;
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = (float)(seed >> 8) / 16777216.0f - 0.5f;
+        float tone = sinf(2.0f * (float)OTT_PI * 110.0f * (float)i / sampleRate);
+        left[i] = 0.5f * tone + noise;
+        right[i] = 0.5f * tone - noise;
+    }
+    
+    BiquadFilter serial[6], block[6];
+    SetStableCrossover(serial, OTT_LOW_MID_CROSSOVER, OTT_MID_HIGH_CROSSOVER, sampleRate);
+    SetStableCrossover(block, OTT_LOW_MID_CROSSOVER, OTT_MID_HIGH_CROSSOVER, sampleRate);
+    
+    for (int64_t start = 0; start < TEST_SAMPLES; start += chunkSamples) {
+        int64_t n = (TEST_SAMPLES - start < chunkSamples) ? TEST_SAMPLES - start : chunkSamples;
+        float* const serialOut[6] = { serialBands[0] + start, serialBands[1] + start, serialBands[2] + start,
+                                      serialBands[3] + start, serialBands[4] + start, serialBands[5] + start };
+        float* const blockOut[6] = { blockBands[0] + start, blockBands[1] + start, blockBands[2] + start,
+                                     blockBands[3] + start, blockBands[4] + start, blockBands[5] + start };
+        ProcessLegacyCrossoverSerial(serial, left + start, right + start, n, advanced, serialOut);
+    
+        LegacyCrossoverKernels kernels;
+        BuildLegacyCrossoverKernels(&kernels, block);
+        ProcessLegacyCrossoverBlock(block, &kernels, left + start, right + start, n, advanced, blockOut);
+    }
+    
+    // Simple mode leaves the mid lines alone
+    double peak = 0.0, maxError = 0.0;
+    for (int band = 0; band < 6; band++) {
+        if (!advanced && (band == 2 || band == 3)) continue;
+        for (int i = 0; i < TEST_SAMPLES; i++) {
+            double error = fabs((double)blockBands[band][i] - serialBands[band][i]);
+            if (!(error <= maxError)) maxError = error;
+            if (fabs(serialBands[band][i]) > peak) peak = fabs(serialBands[band][i]);
+        }
+    }
+    return maxError / peak;
+}
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+int main(void)
+{
+    static const float sampleRates[] = { 44100.0f, 96000.0f, 192000.0f };
+    static const int64_t chunkSizes[] = { OTT_BIQUAD_BLOCK_MIN_SAMPLES, 256, 1000 };
+    int failures = 0;
+    
+    for (size_t rate = 0; rate < sizeof(sampleRates) / sizeof(sampleRates[0]); rate++) {
+        for (size_t chunk = 0; chunk < sizeof(chunkSizes) / sizeof(chunkSizes[0]); chunk++) {
+            for (int advanced = 0; advanced <= 1; advanced++) {
+                double error = MeasureBlockError(sampleRates[rate], chunkSizes[chunk], advanced);
+                bool pass = error < BLOCK_MAX_ERROR;
+                printf("%-4s %-8s %6.0f Hz, chunks of %4d  %.3g of peak (bound %.3g)\n", pass ? "ok" : "FAIL",
+                       advanced ? "advanced" : "simple", sampleRates[rate], (int)chunkSizes[chunk], error,
+                       BLOCK_MAX_ERROR);
+                failures += !pass;
+            }
+        }
+    }
+    
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * OTT Compressor Math Test
+ * Gain error of the OTT_MATH_FAST and OTT_MATH_TABLE backends against libm,
+ * and of the float gain computer against the double one
+ */
+
+#include "ott_plugin.h"
+#include <math.h>
+#include <stdio.h>
+
+// Bounds documented on OTTMathBackend and OTT_PRECISION_FLOAT in ott_plugin.h
+#define FAST_MAX_ERROR_DB       1e-5
+#define TABLE_MAX_ERROR_DB      0.1
+#define FLOAT_MAX_ERROR_DB      1e-4
+
+#define SWEEP_SAMPLES           200000
+
+// ============================================================================
+// LEVEL SWEEP
+// ============================================================================
+
+// Input power at sample i of the sweep: -90 dB to +6 dB and back, with
+// 20 dB steps every 64 samples
+static double SweepInputPower(int i)
+{
+    double phase = (double)i / SWEEP_SAMPLES;
+    double sweepDb = -90.0 + 96.0 * (1.0 - fabs(2.0 * phase - 1.0));
+    double levelDb = sweepDb - ((i / 64) % 2) * 20.0;
+    return pow(10.0, levelDb / 10.0) + NOISE_FLOOR;
+}
+
+// Largest gain difference in dB between a libm and a backend copy of comp
+static double MeasureBackendError(const CompressorState* comp, OTTMathBackend backend)
+{
+    CompressorState exact = *comp;
+    CompressorState test = *comp;
+    SetCompressorMathBackend(&exact, OTT_MATH_LIBM);
+    SetCompressorMathBackend(&test, backend);
+    
+    double maxErrorDb = 0.0;
+    
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double inputPower = SweepInputPower(i);
+        double exactGain = ProcessCompressorBand(&exact, inputPower, 1.0, 1.0, ENVELOPE_TIME_CONSTANT);
+        double testGain = ProcessCompressorBand(&test, inputPower, 1.0, 1.0, ENVELOPE_TIME_CONSTANT);
+    
+        double errorDb = fabs(20.0 * log10(testGain / exactGain));
+        if (!(errorDb <= maxErrorDb)) maxErrorDb = errorDb;
+    }
+    
+    return maxErrorDb;
+}
+
+// Largest gain difference in dB between comp in double and its
+// CompressorStateF copy; both use comp's math backend
+static double MeasurePrecisionError(const CompressorState* comp)
+{
+    CompressorState exact = *comp;
+    CompressorStateF single;
+    LoadCompressorStateF(&single, comp);
+    
+    double maxErrorDb = 0.0;
+    
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double inputPower = SweepInputPower(i);
+        double exactGain = ProcessCompressorBand(&exact, inputPower, 1.0, 1.0, ENVELOPE_TIME_CONSTANT);
+        float singleGain = ProcessCompressorBandF(&single, (float)inputPower, 1.0f, 1.0f,
+                                                  (float)ENVELOPE_TIME_CONSTANT);
+        
+        double errorDb = fabs(20.0 * log10(singleGain / exactGain));
+        if (!(errorDb <= maxErrorDb)) maxErrorDb = errorDb;
+    }
+    
+    return maxErrorDb;
+}
+
+static int Report(const char* name, double errorDb, double boundDb)
+{
+    bool pass = errorDb < boundDb;
+    printf("%-4s %-40s %.3g dB (bound %.3g dB)\n", pass ? "ok" : "FAIL", name, errorDb, boundDb);
+    return pass ? 0 : 1;
+}
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+int main(void)
+{
+    enum { CASES = 6 };
+    static const char* caseNames[CASES] = { "low band", "mid band", "high band",
+                                            "main path -20 dB", "main path -15 dB", "main path -10 dB" };
+    static const double thresholds[3] = { -20.0, -15.0, -10.0 };
+    static const double upwardRatios[3] = { 2.0, 2.5, 3.0 };
+    CompressorState cases[CASES];
+    
+    // OTT's bands as OTT_Initialize sets them up (alternative path)
+    OTTPlugin plugin;
+    OTT_Initialize(&plugin, 44100.0f);
+    for (int band = 0; band < 3; band++) {
+        cases[band] = plugin.compressors[band];
+    }
+    OTT_Cleanup(&plugin);
+    
+    // Main path (ratio_state at or below NEGATIVE_THRESHOLD)
+    for (int i = 0; i < 3; i++) {
+        InitializeCompressor(&cases[3 + i]);
+        SetCompressorParameters(&cases[3 + i], thresholds[i], -1.0, 0.1, 0.01, upwardRatios[i]);
+        cases[3 + i].release_time = 0.7;
+    }
+    
+    int failures = 0;
+    char name[64];
+    
+    for (int i = 0; i < CASES; i++) {
+        snprintf(name, sizeof(name), "fast, %s", caseNames[i]);
+        failures += Report(name, MeasureBackendError(&cases[i], OTT_MATH_FAST), FAST_MAX_ERROR_DB);
+    }
+    
+    for (int i = 0; i < CASES; i++) {
+        snprintf(name, sizeof(name), "table, %s", caseNames[i]);
+        failures += Report(name, MeasureBackendError(&cases[i], OTT_MATH_TABLE), TABLE_MAX_ERROR_DB);
+    }
+    
+    // release_time moves the MIN_GAIN_THRESHOLD corner of the below-threshold
+    // gain and sets its slope; cover the ends of the documented range
+    static const double releaseTimes[4] = { -3.0, 0.5, 4.0, 5.0 };
+    for (int r = 0; r < 4; r++) {
+        for (int i = 0; i < CASES; i += 3) {
+            CompressorState comp = cases[i];
+            comp.release_time = releaseTimes[r];
+            snprintf(name, sizeof(name), "table, %s, release %g", caseNames[i], releaseTimes[r]);
+            failures += Report(name, MeasureBackendError(&comp, OTT_MATH_TABLE), TABLE_MAX_ERROR_DB);
+        }
+    }
+    
+    // A threshold far above the sweep keeps x below the grid
+    CompressorState belowGrid = cases[0];
+    belowGrid.threshold = 100.0;
+    belowGrid.release_time = 0.5;
+    failures += Report("table, below the grid", MeasureBackendError(&belowGrid, OTT_MATH_TABLE), TABLE_MAX_ERROR_DB);
+    
+    for (int backend = OTT_MATH_LIBM; backend <= OTT_MATH_FAST; backend++) {
+        for (int i = 0; i < CASES; i++) {
+            CompressorState comp = cases[i];
+            SetCompressorMathBackend(&comp, (OTTMathBackend)backend);
+            snprintf(name, sizeof(name), "float %s, %s", backend == OTT_MATH_LIBM ? "libm" : "fast", caseNames[i]);
+            failures += Report(name, MeasurePrecisionError(&comp), FLOAT_MAX_ERROR_DB);
+        }
+    }
+    
+    return failures ? 1 : 0;
+}
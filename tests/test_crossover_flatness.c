@@ -0,0 +1,115 @@
+/**
+ * OTT Crossover Flatness Test
+ * The bands of the LR4 and linear-phase crossovers must sum flat
+ */
+
+#include "ott_plugin.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// LR4 sums to an allpass and the linear-phase split to a pure delay, so
+// both should be flat to float rounding
+#define FLATNESS_MAX_DEVIATION_DB   1e-3f
+
+// ============================================================================
+// BAND SUM RESPONSE
+// ============================================================================
+
+/*
+ * Largest deviation from 0 dB, in dB, of the sum of all bands between 20 Hz
+ * and 20 kHz for a topology's split into numBands bands at the band
+ * controls' default points. The impulse response of the band sum is run
+ * long enough to decay and then evaluated by direct DFT at log-spaced
+ * points. NAN when the linear-phase buffers can't be had.
+ */
+static float MeasureCrossoverFlatness(OTTCrossoverTopology topology, int numBands, float sampleRate)
+{
+    enum { RESPONSE_SAMPLES = 8192, FREQUENCY_POINTS = 64 };
+    static float response[RESPONSE_SAMPLES];
+    
+    // Crossover points as UpdateCrossoverFrequencies places them
+    float frequencies[OTT_MAX_CROSSOVERS];
+    const int points = numBands - 1;
+    for (int point = 0; point < points; point++) {
+        frequencies[point] = (points == 1) ? sqrtf(OTT_LOW_MID_CROSSOVER * OTT_MID_HIGH_CROSSOVER) :
+                             OTT_LOW_MID_CROSSOVER * powf(OTT_MID_HIGH_CROSSOVER / OTT_LOW_MID_CROSSOVER,
+                                                          (float)point / (float)(points - 1));
+    }
+    
+    SVFCoefficients lr4Points[OTT_MAX_CROSSOVERS];
+    SVFStageState lr4Stages[OTT_LR4_MAX_STAGES];
+    SetupLR4Crossover(lr4Points, lr4Stages, numBands, frequencies, sampleRate);
+    
+    LinearPhaseCrossover linearPhase = { .maxPoints = (uint32_t)points };
+    void* linearPhaseMemory = NULL;
+    if (topology == OTT_CROSSOVER_LINEAR_PHASE) {
+        linearPhaseMemory = aligned_alloc(OTT_CACHE_LINE_SIZE, BindLinearPhaseCrossover(&linearPhase, NULL));
+        if (!linearPhaseMemory) return NAN;
+        BindLinearPhaseCrossover(&linearPhase, linearPhaseMemory);
+        PrepareLinearPhaseCrossover(&linearPhase);
+        DesignLinearPhaseKernels(&linearPhase, numBands, frequencies, sampleRate);
+        SwapLinearPhaseKernels(&linearPhase);
+    }
+    
+    for (int n = 0; n < RESPONSE_SAMPLES; n++) {
+        float input = (n == 0) ? 1.0f : 0.0f;
+        float bands[2 * OTT_MAX_BANDS];
+        if (topology == OTT_CROSSOVER_LINEAR_PHASE) {
+            ProcessLinearPhaseCrossover(&linearPhase, numBands, input, input, bands);
+        } else {
+            ProcessLR4Crossover(lr4Points, lr4Stages, numBands, input, input, bands);
+        }
+        response[n] = 0.0f;
+        for (int band = 0; band < numBands; band++) {
+            response[n] += bands[2 * band];
+        }
+    }
+    free(linearPhaseMemory);
+    
+    float worstDb = 0.0f;
+    for (int point = 0; point < FREQUENCY_POINTS; point++) {
+        double frequency = 20.0 * pow(1000.0, (double)point / (FREQUENCY_POINTS - 1));
+        double omega = 2.0 * OTT_PI * frequency / sampleRate;
+        double re = 0.0, im = 0.0;
+        for (int n = 0; n < RESPONSE_SAMPLES; n++) {
+            re += response[n] * cos(omega * n);
+            im -= response[n] * sin(omega * n);
+        }
+    
+        float deviationDb = fabsf((float)(10.0 * log10(re * re + im * im)));
+        if (!(deviationDb <= worstDb)) worstDb = deviationDb;
+    }
+    return worstDb;
+}
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+int main(void)
+{
+    static const struct {
+        const char* name;
+        OTTCrossoverTopology topology;
+    } topologies[] = {
+        { "LR4", OTT_CROSSOVER_LR4 },
+        { "linear-phase", OTT_CROSSOVER_LINEAR_PHASE },
+    };
+    static const float sampleRates[] = { 44100.0f, 48000.0f, 96000.0f, 192000.0f };
+    int failures = 0;
+    
+    for (size_t i = 0; i < sizeof(topologies) / sizeof(topologies[0]); i++) {
+        for (size_t rate = 0; rate < sizeof(sampleRates) / sizeof(sampleRates[0]); rate++) {
+            for (int numBands = OTT_MIN_BANDS; numBands <= OTT_MAX_BANDS; numBands++) {
+                float deviationDb = MeasureCrossoverFlatness(topologies[i].topology, numBands, sampleRates[rate]);
+                bool pass = deviationDb < FLATNESS_MAX_DEVIATION_DB;
+                printf("%-4s %-12s %6.0f Hz, %d bands  %.3g dB (bound %.3g dB)\n", pass ? "ok" : "FAIL",
+                       topologies[i].name, sampleRates[rate], numBands, deviationDb, FLATNESS_MAX_DEVIATION_DB);
+                failures += !pass;
+            }
+        }
+    }
+    
+    return failures ? 1 : 0;
+}
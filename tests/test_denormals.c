@@ -0,0 +1,122 @@
+/**
+ * OTT Denormal Test
+ * Silence after a transient must not leave subnormal state or output
+ *
+ * Only the LR4 topology is covered: the legacy sections' coefficients are
+ * unstable as decoded (their state goes non-finite within a block), so
+ * they can't show whether a tail decays cleanly. The software flush covers
+ * both networks, but only the LR4 cases back that claim.
+ */
+
+#include "ott_plugin.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+#define TAIL_BLOCKS             2000
+
+// ============================================================================
+// SILENCE TAIL
+// ============================================================================
+
+static inline bool IsSubnormal(float x)
+{
+    return x != 0.0f && fabsf(x) < FLT_MIN;
+}
+
+// Flags one value the test reads; a NaN or inf would pass IsSubnormal
+static inline void CheckValue(float x, bool* subnormal, bool* nonFinite)
+{
+    *subnormal |= IsSubnormal(x);
+    *nonFinite |= !isfinite(x);
+}
+
+/*
+ * A fresh instance gets a short full-scale burst, then tailBlocks blocks of
+ * digital silence through OTT_ProcessAudio (no FTZ/DAZ guard, so only the
+ * software flush is at work). Returns how many tail blocks ended with
+ * subnormal crossover or smoother state or produced a subnormal output
+ * sample; blocks with any non-finite value are counted in *nonFiniteBlocks.
+ */
+static int32_t CountSubnormalTailBlocks(OTTCrossoverTopology topology, int32_t numBands, float sampleRate,
+                                        int32_t tailBlocks, int32_t* nonFiniteBlocks)
+{
+    enum { BLOCK_SAMPLES = 256, BURST_BLOCKS = 8 };
+    float inLeft[BLOCK_SAMPLES], inRight[BLOCK_SAMPLES];
+    float outLeft[BLOCK_SAMPLES] = { 0.0f }, outRight[BLOCK_SAMPLES] = { 0.0f };
+    float* inputs[2] = { inLeft, inRight };
+    float* outputs[2] = { outLeft, outRight };
+    
+    OTTPlugin plugin;
+    OTT_Initialize(&plugin, sampleRate);
+    OTT_SetCrossoverTopology(&plugin, topology);
+    OTT_SetBandCount(&plugin, numBands);
+    plugin.finalGain = 1.0f;
+    
+    int32_t subnormalBlocks = 0;
+    for (int32_t block = 0; block < BURST_BLOCKS + tailBlocks; block++) {
+        for (int i = 0; i < BLOCK_SAMPLES; i++) {
+            float burst = (block < BURST_BLOCKS) ? sinf((float)(block * BLOCK_SAMPLES + i) * 0.07f) : 0.0f;
+            inLeft[i] = burst;
+            inRight[i] = burst * 0.7f;
+        }
+        OTT_ProcessAudio(&plugin, inputs, outputs, BLOCK_SAMPLES);
+        if (block < BURST_BLOCKS) continue;
+    
+        bool subnormal = false, nonFinite = false;
+        CheckValue(plugin.depthSmoother.value, &subnormal, &nonFinite);
+        CheckValue(plugin.upwardSmoother.value, &subnormal, &nonFinite);
+        CheckValue(plugin.outputSmoother.value, &subnormal, &nonFinite);
+        for (int i = 0; i < 6; i++) {
+            CheckValue(plugin.crossoverFilters[i].state1, &subnormal, &nonFinite);
+            CheckValue(plugin.crossoverFilters[i].state2, &subnormal, &nonFinite);
+        }
+        for (int stage = 0; stage < OTT_LR4_STAGE_COUNT((int)plugin.numBands); stage++) {
+            for (int lane = 0; lane < 4; lane++) {
+                CheckValue(plugin.lr4Stages[stage].ic1eq[lane], &subnormal, &nonFinite);
+                CheckValue(plugin.lr4Stages[stage].ic2eq[lane], &subnormal, &nonFinite);
+            }
+        }
+        for (int i = 0; i < BLOCK_SAMPLES; i++) {
+            CheckValue(outLeft[i], &subnormal, &nonFinite);
+            CheckValue(outRight[i], &subnormal, &nonFinite);
+        }
+        subnormalBlocks += subnormal;
+        *nonFiniteBlocks += nonFinite;
+    }
+    
+    OTT_Cleanup(&plugin);
+    return subnormalBlocks;
+}
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+int main(void)
+{
+    static const struct {
+        const char* name;
+        OTTCrossoverTopology topology;
+        int32_t numBands;
+    } cases[] = {
+        { "LR4, 3 bands", OTT_CROSSOVER_LR4, 3 },
+        { "LR4, 8 bands", OTT_CROSSOVER_LR4, 8 },
+    };
+    static const float sampleRates[] = { 44100.0f, 96000.0f };
+    int failures = 0;
+    
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        for (size_t rate = 0; rate < sizeof(sampleRates) / sizeof(sampleRates[0]); rate++) {
+            int32_t nonFinite = 0;
+            int32_t count = CountSubnormalTailBlocks(cases[i].topology, cases[i].numBands, sampleRates[rate],
+                                                     TAIL_BLOCKS, &nonFinite);
+            bool pass = count == 0 && nonFinite == 0;
+            printf("%-4s %-16s %6.0f Hz  %d of %d tail blocks subnormal, %d non-finite\n", pass ? "ok" : "FAIL",
+                   cases[i].name, sampleRates[rate], count, TAIL_BLOCKS, nonFinite);
+            failures += !pass;
+        }
+    }
+    
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * OTT Engine Equivalence Test
+ * OTT_ENGINE_STAGED and OTT_ENGINE_FUSED must produce the same output,
+ * bit for bit
+ *
+ * The legacy sections' coefficients are unstable as decoded and their
+ * output goes non-finite, where any two runs agree, so legacy cases get
+ * stable sections written into the plugin instead (they keep them as long
+ * as no band control moves). Each case also has to stay finite and
+ * non-silent, so a match can't come from both engines failing alike.
+ *
+ * The same runs check OTT_SetFilterKernel: the kernel must not change LR4
+ * output at all, and on the stable legacy sections BLOCK must stay within
+ * KERNEL_MAX_ERROR of SERIAL.
+ */
+
+#include "ott_plugin.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_BLOCKS             20
+
+// Largest output difference between the legacy kernels, relative to the
+// output peak; the same bound tests/test_block_kernel.c puts on the
+// crossover alone
+#define KERNEL_MAX_ERROR        1e-5
+
+// ============================================================================
+// CASE SETUP
+// ============================================================================
+
+typedef struct {
+    const char* name;
+    OTTCrossoverTopology topology;
+    int32_t numBands;
+    bool advanced;
+    bool modulate;                  // Move the band controls every block
+    float lookaheadMs;
+    int32_t rampSamples;            // 0 = default
+    int32_t oversampling;           // 0 or 1 = none
+    OTTCompressorPrecision precision;
+    OTTMathBackend math;
+    OTTFilterKernel kernel;
+} EngineCase;
+
+// Stable state-variable sections in the legacy recurrence, as in
+// tests/test_block_kernel.c
+static void SetStableLegacySections(OTTPlugin* plugin, float sampleRate)
+{
+    for (int i = 0; i < 6; i++) {
+        BiquadFilter* filter = &plugin->crossoverFilters[i];
+        double g = CrossoverPrewarp((i < 4) ? OTT_LOW_MID_CROSSOVER : OTT_MID_HIGH_CROSSOVER, sampleRate);
+        double k = sqrt(2.0);
+        double a1 = 1.0 / (1.0 + g * (g + k));
+        filter->b0 = 1.0f;
+        filter->b1 = (float)k;
+        filter->coeff_a1 = (float)a1;
+        filter->coeff_a2 = (float)(a1 * g);
+        filter->coeff_b2 = (float)(a1 * g * g);
+    }
+}
+
+static OTTPlugin* CreateCasePlugin(const EngineCase* test, OTTEngineMode engine)
+{
+    OTTInstanceLimits limits = {
+        .maxBlockSize = OTT_DEFAULT_CHUNK_SIZE,
+        .maxLatencySamples = 4096,
+        .maxBands = OTT_MAX_BANDS,
+        .linearPhase = test->topology == OTT_CROSSOVER_LINEAR_PHASE,
+        .maxOversampling = test->oversampling ? test->oversampling : 1,
+    };
+    OTTPlugin* plugin = OTT_CreatePlugin(44100.0f, &limits);
+    if (!plugin) return NULL;
+    
+    OTT_SetEngineMode(plugin, engine);
+    OTT_SetCrossoverTopology(plugin, test->topology);
+    OTT_SetBandCount(plugin, test->numBands);
+    OTT_SetCompressorPrecision(plugin, test->precision);
+    OTT_SetMathBackend(plugin, test->math);
+    OTT_SetFilterKernel(plugin, test->kernel);
+    if (test->oversampling) OTT_SetOversampling(plugin, test->oversampling);
+    if (test->rampSamples) OTT_SetParameterRamp(plugin, test->rampSamples);
+    if (test->lookaheadMs > 0.0f) OTT_SetLookahead(plugin, test->lookaheadMs);
+    if (test->advanced) OTT_SetParameter(plugin, OTT_PARAM_ADVANCED_MODE, 1.0f);
+    if (test->topology == OTT_CROSSOVER_LEGACY) SetStableLegacySections(plugin, 44100.0f);
+    plugin->finalGain = 1.0f;
+    return plugin;
+}
+
+// ============================================================================
+// ENGINE RUN
+// ============================================================================
+
+/*
+ * Runs TEST_BLOCKS host blocks of uneven length (single samples, odd
+ * sizes, longer than a chunk) of a gated tone over noise through
+ * OTT_Process, interleaving the output into out. Returns the number of
+ * samples written, or -1 when the instance can't be had.
+ */
+static int32_t RunEngine(const EngineCase* test, OTTEngineMode engine, float* out)
+{
+    enum { MAX_BLOCK = 4096 };
+    static const int32_t blockSizes[5] = { 512, 1, 3, MAX_BLOCK, 77 };
+    static float inLeft[MAX_BLOCK], inRight[MAX_BLOCK], outLeft[MAX_BLOCK], outRight[MAX_BLOCK];
+    float* inputs[2] = { inLeft, inRight };
+    float* outputs[2] = { outLeft, outRight };
+    
+    OTTPlugin* plugin = CreateCasePlugin(test, engine);
+    if (!plugin) return -1;
+    
+    uint32_t seed = 1;
+    int32_t t = 0, written = 0;
+    for (int32_t block = 0; block < TEST_BLOCKS; block++) {
+        int32_t n = blockSizes[block % 5];
+        for (int32_t i = 0; i < n; i++, t++) {
+            seed = seed * 1664525u + 1013904223u;
+            float noise = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 0.02f;
+            inLeft[i] = 0.5f * sinf((float)t * 0.05f) * (float)(t % 3000 < 1500) + noise;
+            inRight[i] = 0.3f * sinf((float)t * 0.031f) - noise;
+        }
+        if (test->modulate) {
+            OTT_SetParameter(plugin, OTT_PARAM_LOW_BAND, (float)(block * 37 % 11) / 10.0f);
+            OTT_SetParameter(plugin, OTT_PARAM_MID_BAND, (float)(block * 53 % 7) / 6.0f);
+            OTT_SetParameter(plugin, OTT_PARAM_HIGH_BAND, (float)(block * 17 % 5) / 4.0f);
+        }
+        OTT_Process(plugin, inputs, outputs, n);
+        for (int32_t i = 0; i < n; i++) {
+            out[written++] = outLeft[i];
+            out[written++] = outRight[i];
+        }
+    }
+    
+    OTT_DestroyPlugin(plugin);
+    return written;
+}
+
+// ============================================================================
+// COMPARISON
+// ============================================================================
+
+/*
+ * Runs case a under engine ea and case b under engine eb and reports the
+ * largest output difference relative to a's peak; a bound of 0 asks for a
+ * bit-for-bit match instead.
+ */
+static int CompareRuns(const char* name, const EngineCase* a, OTTEngineMode ea, const EngineCase* b,
+                       OTTEngineMode eb, double bound)
+{
+    enum { MAX_OUTPUT = 2 * TEST_BLOCKS * 4096 };
+    static float first[MAX_OUTPUT], second[MAX_OUTPUT];
+    int32_t firstCount = RunEngine(a, ea, first);
+    int32_t secondCount = RunEngine(b, eb, second);
+    
+    int32_t mismatches = 0, nonFinite = 0;
+    double peak = 0.0, maxError = 0.0;
+    for (int32_t n = 0; n < firstCount && firstCount == secondCount; n++) {
+        mismatches += memcmp(&first[n], &second[n], sizeof(float)) != 0;
+        nonFinite += !isfinite(first[n]) + !isfinite(second[n]);
+        double error = fabs((double)first[n] - second[n]);
+        if (!(error <= maxError)) maxError = error;
+        if (fabs(first[n]) > peak) peak = fabs(first[n]);
+    }
+    
+    bool pass = firstCount > 0 && firstCount == secondCount && nonFinite == 0 && peak > 0.0 &&
+                ((bound == 0.0) ? mismatches == 0 : maxError / peak < bound);
+    if (bound == 0.0) {
+        printf("%-4s %-50s %d of %d samples differ, %d non-finite, peak %.3g\n", pass ? "ok" : "FAIL", name,
+               mismatches, firstCount, nonFinite, peak);
+    } else {
+        printf("%-4s %-50s %.3g of peak (bound %.3g), %d non-finite, peak %.3g\n", pass ? "ok" : "FAIL", name,
+               maxError / peak, bound, nonFinite, peak);
+    }
+    return pass ? 0 : 1;
+}
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+int main(void)
+{
+    static const EngineCase cases[] = {
+        { .name = "LR4, 3 bands, simple", .topology = OTT_CROSSOVER_LR4, .numBands = 3 },
+        { .name = "LR4, 3 bands, advanced", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true },
+        { .name = "LR4, 3 bands, modulated", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true,
+          .modulate = true },
+        { .name = "LR4, 5 bands, modulated", .topology = OTT_CROSSOVER_LR4, .numBands = 5, .advanced = true,
+          .modulate = true },
+        { .name = "LR4, 8 bands, float", .topology = OTT_CROSSOVER_LR4, .numBands = 8, .advanced = true,
+          .precision = OTT_PRECISION_FLOAT },
+        { .name = "LR4, fast math", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true,
+          .modulate = true, .math = OTT_MATH_FAST },
+        { .name = "LR4, table math", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true,
+          .modulate = true, .math = OTT_MATH_TABLE },
+        { .name = "LR4, 8 bands, float, fast", .topology = OTT_CROSSOVER_LR4, .numBands = 8, .advanced = true,
+          .precision = OTT_PRECISION_FLOAT, .math = OTT_MATH_FAST },
+        { .name = "LR4, lookahead 5 ms", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true,
+          .lookaheadMs = 5.0f },
+        { .name = "LR4, ramp 64", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true,
+          .modulate = true, .rampSamples = 64 },
+        { .name = "LR4, oversampling 2", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true,
+          .oversampling = 2 },
+        { .name = "LR4, 6 bands, oversampling 8", .topology = OTT_CROSSOVER_LR4, .numBands = 6, .advanced = true,
+          .lookaheadMs = 3.0f, .oversampling = 8 },
+        { .name = "LR4, block kernel", .topology = OTT_CROSSOVER_LR4, .numBands = 3, .advanced = true,
+          .kernel = OTT_FILTER_KERNEL_BLOCK },
+        { .name = "linear-phase, 3 bands", .topology = OTT_CROSSOVER_LINEAR_PHASE, .numBands = 3,
+          .advanced = true },
+        { .name = "linear-phase, modulated", .topology = OTT_CROSSOVER_LINEAR_PHASE, .numBands = 4,
+          .advanced = true, .modulate = true },
+        { .name = "legacy, simple", .topology = OTT_CROSSOVER_LEGACY, .numBands = 3 },
+        { .name = "legacy, advanced", .topology = OTT_CROSSOVER_LEGACY, .numBands = 3, .advanced = true },
+        { .name = "legacy, block kernel", .topology = OTT_CROSSOVER_LEGACY, .numBands = 3,
+          .kernel = OTT_FILTER_KERNEL_BLOCK },
+        { .name = "legacy, advanced, block kernel", .topology = OTT_CROSSOVER_LEGACY, .numBands = 3,
+          .advanced = true, .kernel = OTT_FILTER_KERNEL_BLOCK },
+    };
+    int failures = 0;
+    char name[96];
+    
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        failures += CompareRuns(cases[i].name, &cases[i], OTT_ENGINE_STAGED, &cases[i], OTT_ENGINE_FUSED, 0.0);
+    }
+    
+    // The kernel setting, SERIAL against BLOCK in the same engine
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (cases[i].kernel != OTT_FILTER_KERNEL_BLOCK) continue;
+        EngineCase serial = cases[i];
+        serial.kernel = OTT_FILTER_KERNEL_SERIAL;
+        double bound = (cases[i].topology == OTT_CROSSOVER_LEGACY) ? KERNEL_MAX_ERROR : 0.0;
+        for (int engine = OTT_ENGINE_STAGED; engine <= OTT_ENGINE_FUSED; engine++) {
+            snprintf(name, sizeof(name), "%s, vs serial (%s)", cases[i].name,
+                     engine == OTT_ENGINE_STAGED ? "staged" : "fused");
+            failures += CompareRuns(name, &serial, (OTTEngineMode)engine, &cases[i], (OTTEngineMode)engine, bound);
+        }
+    }
+    
+    return failures ? 1 : 0;
+}